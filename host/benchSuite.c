@@ -0,0 +1,84 @@
+#include <stdlib.h>
+#include <string.h>
+#include "hostAPI.h"
+#include "benchmark.h"
+
+/*
+ * Runs the microbenchmark suite on the host and gates on regressions
+ * Usage: benchSuite [-u] [-r rounds] [-t percent] [baseline file]
+ *   -u          Replace the baseline with this run (needed after adding, removing, or renaming cases)
+ *   -r rounds   Suite repetitions; each case keeps its fastest round (default 7)
+ *   -t percent  Allowed slowdown of a median (default 15, host timing is noisier than cycle counts)
+ * Exits nonzero if any median is slower than the baseline by more than that, or if the cases do
+ * not match the baseline's
+ * Code placement changes timings by several ns, so run with address randomization off (make bench does)
+ */
+
+int main(int argc, char **argv)
+{
+	const char *file = "bin/bench.baseline";
+	bool update = false;
+	int rounds = 7;
+	float tolerance = 0.15;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "-u") == 0)
+		{
+			update = true;
+		}
+		else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc)
+		{
+			rounds = atoi(argv[++i]);
+		}
+		else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc)
+		{
+			tolerance = atof(argv[++i]) / 100;
+		}
+		else
+		{
+			file = argv[i];
+		}
+	}
+
+	benchResult best[BENCH_CASES], round[BENCH_CASES];
+	int count = 0;
+
+	//The fastest round is the one least disturbed by the rest of the machine
+	for (int r = 0; r < rounds; r++)
+	{
+		count = bench_RunSuite(round);
+
+		for (int i = 0; i < count; i++)
+		{
+			if (r == 0 || round[i].median < best[i].median)
+			{
+				best[i] = round[i];
+			}
+		}
+	}
+
+	const int failed = bench_Compare(best, count, file, update, tolerance);
+
+	if (failed < 0)
+	{
+		printf("Cannot read or write baseline %s (rerun with -u to replace it)\n", file);
+		return 1;
+	}
+
+	printf("case           min ns  median ns   p90 ns   p99 ns  baseline\n");
+
+	for (int i = 0; i < count; i++)
+	{
+		printf("%-12s %8.2f %10.2f %8.2f %8.2f %9.2f%s\n", best[i].name, best[i].min, best[i].median, best[i].p90,
+			best[i].p99, best[i].baseline, best[i].regressed ? "  REGRESSED" : best[i].unmatched ? "  NO BASELINE" : "");
+	}
+
+	if (failed > 0)
+	{
+		printf("%d case(s) regressed more than %d%% or do not match the cases in %s\n", failed, (int)(tolerance * 100 + 0.5), file);
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,103 @@
+#include <stdlib.h>
+#include <string.h>
+#include "hostAPI.h"
+#include "flywheelSim.h"
+
+/*
+ * Compares the velocity controllers on a simulated flywheel
+ * Usage: flywheelBench [-n runs] [-t controller scenario]
+ *   -n runs                  Noise seeds per controller and scenario (default 200)
+ *   -t controller scenario   Print a CSV trace (ms,rpm,power) of one run instead (indices into the tables)
+ */
+
+static const simScenario scenarios[] = {
+	{"spin-up",     2500, 6000, 0, {0}, 0, 1},
+	{"rapid fire",  2500, 8000, 4, {4500, 5000, 5500, 6000}, 0, 1},
+	{"low battery", 2500, 8000, 2, {5000, 6500}, 7.0, 1},
+	{"long shot",   3000, 8000, 2, {5000, 6500}, 0, 1}
+};
+
+static const char *controllerNames[] = {"vel_TBH", "vel_PID", "bangBang"};
+
+//Hand-tuned defaults for the default plant
+static const float controllerGains[][2] = {
+	{0.025, 90}, //TBH gain, open loop approximation
+	{0.01, 5},   //PID kP, kD
+	{127, 70}    //BangBang high and low power
+};
+
+static void printTrace(int ms, float rpm, int power)
+{
+	printf("%d,%.1f,%d\n", ms, rpm, power);
+}
+
+int main(int argc, char **argv)
+{
+	int runs = 200, traceController = -1, traceScenario = 0;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "-n") == 0 && i + 1 < argc)
+		{
+			runs = atoi(argv[++i]);
+		}
+		else if (strcmp(argv[i], "-t") == 0 && i + 2 < argc)
+		{
+			traceController = atoi(argv[++i]);
+			traceScenario = atoi(argv[++i]);
+		}
+	}
+
+	simPlant plant;
+	simController ctrl;
+	simResult result;
+	sim_DefaultPlant(&plant);
+
+	if (traceController >= 0)
+	{
+		sim_InitController(&ctrl, traceController, controllerGains[traceController][0], controllerGains[traceController][1], plant.ticksPerRev);
+		printf("ms,rpm,power\n");
+		sim_Run(&plant, &ctrl, &(scenarios[traceScenario]), &result, printTrace);
+		return 0;
+	}
+
+	const int scenarioCount = sizeof(scenarios) / sizeof(scenarios[0]);
+	unsigned long totalRuns = 0;
+	const unsigned long long start = host_WallNanos();
+
+	printf("%-12s %-10s %8s %9s %8s %9s %8s %8s\n", "scenario", "controller", "rise ms", "overshoot", "settle", "recovery", "rms rpm", "ns/step");
+
+	for (int s = 0; s < scenarioCount; s++)
+	{
+		for (int c = 0; c < 3; c++)
+		{
+			simResult mean = {0};
+			simScenario scenario = scenarios[s];
+			sim_InitController(&ctrl, c, controllerGains[c][0], controllerGains[c][1], plant.ticksPerRev);
+
+			//Average over noise seeds
+			for (int r = 0; r < runs; r++)
+			{
+				scenario.seed = r + 1;
+				sim_Run(&plant, &ctrl, &scenario, &result, NULL);
+
+				mean.riseTime += result.riseTime / runs;
+				mean.overshoot += result.overshoot / runs;
+				mean.settleTime += result.settleTime / runs;
+				mean.recovery += result.recovery / runs;
+				mean.rmsError += result.rmsError / runs;
+				mean.stepNanos += result.stepNanos / runs;
+			}
+
+			totalRuns += runs;
+
+			printf("%-12s %-10s %8.0f %8.1f%% %8.0f %9.0f %8.1f %8.1f\n", s == 0 || c == 0 ? scenarios[s].name : "",
+				controllerNames[c], mean.riseTime, mean.overshoot, mean.settleTime, mean.recovery, mean.rmsError, mean.stepNanos);
+		}
+	}
+
+	const double seconds = (host_WallNanos() - start) / 1e9;
+	printf("%lu runs in %.2f s (%.0f runs/s)\n", totalRuns, seconds, totalRuns / seconds);
+
+	return 0;
+}
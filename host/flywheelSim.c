@@ -0,0 +1,300 @@
+#include "hostAPI.h"
+#include "math.h"
+#include "flywheelSim.h"
+
+/**
+ * Fills in a 15:1 geared up flywheel driven by two turbo 393 motors
+ *
+ * @param plant The plant
+ */
+void sim_DefaultPlant(simPlant *plant)
+{
+	//Turbo gear 393 motors
+	plant->motorCount = 2;
+	plant->stallTorque = 0.953;
+	plant->stallCurrent = 4.8;
+	plant->freeSpeed = 240 * 2 * PI / 60;
+	plant->nominalVoltage = 7.2;
+
+	//5" wheel geared up 15:1
+	plant->gearRatio = 15;
+	plant->inertia = 6e-4;
+	plant->coulombFriction = 0.005;
+	plant->viscousFriction = 2e-5;
+
+	plant->batteryVoltage = 7.8;
+	plant->batteryResistance = 0.15;
+
+	//Quad encoder on the flywheel axle
+	plant->ticksPerRev = 360;
+	plant->noise = 0.5;
+
+	plant->ballInertia = 1.2e-4;
+
+	plant->omega = 0;
+	plant->angle = 0;
+	plant->current = 0;
+	plant->voltage = plant->batteryVoltage;
+}
+
+/**
+ * Initializes a controller under test
+ *
+ * @param ctrl The controller
+ * @param type Controller type
+ * @param gain0 TBH gain, PID kP, or BangBang high power
+ * @param gain1 TBH open loop approximation, PID kD, or BangBang low power
+ * @param ticksPerRev Encoder ticks per flywheel rev
+ */
+void sim_InitController(simController *ctrl, const simControllerType type, const float gain0, const float gain1, const float ticksPerRev)
+{
+	ctrl->type = type;
+	ctrl->gains[0] = gain0;
+	ctrl->gains[1] = gain1;
+
+	switch (type)
+	{
+		case SIM_TBH:
+			vel_TBH_InitController(&(ctrl->tbh), gain0, gain1, ticksPerRev);
+			break;
+
+		case SIM_PID:
+			vel_PID_InitController(&(ctrl->pid), gain0, gain1, ticksPerRev);
+			break;
+
+		case SIM_BANGBANG:
+			bangBang_InitController(&(ctrl->bb), gain0, gain1, ticksPerRev);
+			break;
+	}
+}
+
+/**
+ * Steps the plant by one SIM_PLANT_STEP with a motor power applied
+ */
+static void simStep(simPlant *p, const int power)
+{
+	const float dt = SIM_PLANT_STEP / 1e6;
+
+	//Battery sags under the previous step's load
+	p->voltage = p->batteryVoltage - p->batteryResistance * (p->current > 0 ? p->current : 0);
+
+	//Each motor sees the PWM average of the battery voltage (unpowered motors coast)
+	float torque = 0;
+	p->current = 0;
+
+	if (power != 0)
+	{
+		const float applied = p->voltage * power / 127.0f;
+		const float backEMF = p->nominalVoltage * (p->omega / p->gearRatio) / p->freeSpeed;
+		const float current = (applied - backEMF) * p->stallCurrent / p->nominalVoltage;
+
+		p->current = current * p->motorCount;
+		torque = p->current * (p->stallTorque / p->stallCurrent) / p->gearRatio;
+	}
+
+	//Friction, which can stop the flywheel but not reverse it
+	torque -= p->viscousFriction * p->omega;
+	const float coulomb = p->omega > 0 ? p->coulombFriction : (p->omega < 0 ? -p->coulombFriction : 0);
+	float omega = p->omega + (torque - coulomb) / p->inertia * dt;
+
+	if (p->omega != 0 && (omega > 0) != (p->omega > 0))
+	{
+		omega = 0;
+	}
+	else if (p->omega == 0 && fabsf(torque) <= p->coulombFriction)
+	{
+		omega = 0;
+	}
+
+	p->omega = omega;
+	p->angle += omega * dt;
+}
+
+/**
+ * Reads the encoder: quantized to whole ticks after adding noise
+ */
+static int simEncoder(const simPlant *p)
+{
+	return (int)floor(p->angle / (2 * PI) * p->ticksPerRev + host_RandomGaussian() * p->noise);
+}
+
+/**
+ * Steps the controller under test
+ */
+static int simControllerStep(simController *ctrl, const float sens)
+{
+	switch (ctrl->type)
+	{
+		case SIM_TBH:
+			return vel_TBH_StepController(&(ctrl->tbh), sens);
+
+		case SIM_PID:
+			return vel_PID_StepController(&(ctrl->pid), sens);
+
+		default:
+			return bangBang_StepController(&(ctrl->bb), sens);
+	}
+}
+
+/**
+ * Runs a scenario in closed loop
+ *
+ * @param plant Plant parameters (state is reset)
+ * @param ctrl Controller (state is reset)
+ * @param scenario The scenario
+ * @param result Metrics of the run
+ * @param trace Called every plant step with (ms, flywheel RPM, output) if not NULL
+ */
+void sim_Run(simPlant *plant, simController *ctrl, const simScenario *scenario, simResult *result, void (*trace)(int, float, int))
+{
+	//Reset plant, controller, clock, and noise
+	plant->omega = 0;
+	plant->angle = 0;
+	plant->current = 0;
+
+	//Scenario battery for this run only
+	const float battery = plant->batteryVoltage;
+
+	if (scenario->batteryVoltage != 0)
+	{
+		plant->batteryVoltage = scenario->batteryVoltage;
+	}
+
+	sim_InitController(ctrl, ctrl->type, ctrl->gains[0], ctrl->gains[1], plant->ticksPerRev);
+
+	switch (ctrl->type)
+	{
+		case SIM_TBH:
+			vel_TBH_SetTargetVelocity(&(ctrl->tbh), scenario->targetRPM, ctrl->gains[1]);
+			break;
+
+		case SIM_PID:
+			vel_PID_SetTargetVelocity(&(ctrl->pid), scenario->targetRPM);
+			break;
+
+		case SIM_BANGBANG:
+			bangBang_SetTargetVelocity(&(ctrl->bb), scenario->targetRPM);
+			break;
+	}
+
+	host_SetMicros(0);
+	host_SeedRandom(scenario->seed);
+
+	const float target = scenario->targetRPM;
+	const float band = target * SIM_SETTLE_BAND;
+	const int firstShot = scenario->shotCount > 0 ? scenario->shots[0] : scenario->duration;
+
+	//Metrics
+	float peak = 0, squaredError = 0, spinSquaredError = 0, recoveryTotal = 0;
+	int rise = -1, inBandSince = -1, errorSamples = 0, spinSamples = 0;
+	int nextShot = 0, recovering = -1, recovered = 0;
+
+	//CPU time, less the cost of reading the clock
+	const unsigned long long clockStart = host_WallNanos();
+	const unsigned long long clockCost = host_WallNanos() - clockStart;
+	unsigned long long stepNanos = 0;
+	int steps = 0;
+
+	int power = 0;
+
+	for (int ms = 0; ms < scenario->duration; ms++)
+	{
+		//Ball shot: the flywheel shares its momentum with the ball
+		if (nextShot < scenario->shotCount && ms == scenario->shots[nextShot])
+		{
+			plant->omega *= plant->inertia / (plant->inertia + plant->ballInertia);
+			recovering = ms;
+			nextShot++;
+		}
+
+		if (ms % SIM_CONTROL_PERIOD == 0)
+		{
+			const float sens = simEncoder(plant);
+			const unsigned long long start = host_WallNanos();
+			power = simControllerStep(ctrl, sens);
+			const unsigned long long elapsed = host_WallNanos() - start;
+			stepNanos += elapsed > clockCost ? elapsed - clockCost : 0;
+			steps++;
+
+			power = power > 127 ? 127 : (power < -127 ? -127 : power);
+		}
+
+		simStep(plant, power);
+		host_AdvanceMicros(SIM_PLANT_STEP);
+
+		const float rpm = plant->omega * 60 / (2 * PI);
+		const float error = target - rpm;
+		const bool inBand = fabsf(error) <= band;
+
+		if (trace != NULL)
+		{
+			trace(ms, rpm, power);
+		}
+
+		if (rise < 0 && rpm >= 0.9f * target)
+		{
+			rise = ms;
+		}
+
+		//Spin-up (before the first shot): settled once the velocity enters the band for good
+		if (ms < firstShot)
+		{
+			peak = rpm > peak ? rpm : peak;
+
+			if (inBand)
+			{
+				inBandSince = inBandSince < 0 ? ms : inBandSince;
+				spinSquaredError += error * error;
+				spinSamples++;
+			}
+			else
+			{
+				inBandSince = -1;
+				spinSquaredError = 0;
+				spinSamples = 0;
+			}
+		}
+		//Shot recovery
+		else if (recovering >= 0)
+		{
+			if (inBand)
+			{
+				recoveryTotal += ms - recovering;
+				recovered++;
+				recovering = -1;
+			}
+		}
+		//Steady state between shots
+		else
+		{
+			squaredError += error * error;
+			errorSamples++;
+		}
+	}
+
+	//Shots never recovered from count until the end of the run
+	if (recovering >= 0)
+	{
+		recoveryTotal += scenario->duration - recovering;
+		recovered++;
+	}
+
+	plant->batteryVoltage = battery;
+
+	result->riseTime = rise < 0 ? scenario->duration : rise;
+	result->overshoot = peak > target ? (peak - target) * 100 / target : 0;
+	//Settling only counts if the band was held long enough before the first shot
+	const bool settled = inBandSince >= 0 && firstShot - inBandSince >= SIM_SETTLE_HOLD;
+
+	if (settled)
+	{
+		squaredError += spinSquaredError;
+		errorSamples += spinSamples;
+	}
+
+	result->settleTime = settled ? inBandSince : scenario->duration;
+	result->recovery = recovered > 0 ? recoveryTotal / recovered : 0;
+	result->rmsError = errorSamples > 0 ? sqrtf(squaredError / errorSamples) : 0;
+	result->stepNanos = steps > 0 ? (float)stepNanos / steps : 0;
+	result->steps = steps;
+}
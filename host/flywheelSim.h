@@ -0,0 +1,128 @@
+#ifndef FLYWHEELSIM_H_
+#define FLYWHEELSIM_H_
+
+#include <stdbool.h>
+#include "bangBang.h"
+#include "velocityPID.h"
+#include "velocityTBH.h"
+
+/*
+ * Closed-loop flywheel simulation for comparing and tuning velocity controllers
+ * The plant is integrated every SIM_PLANT_STEP us on the virtual clock and the controller is stepped
+ * every SIM_CONTROL_PERIOD ms through the normal library API, reading a quantized, noisy encoder
+ */
+
+#define SIM_PLANT_STEP     1000 //Plant integration step in us
+#define SIM_CONTROL_PERIOD 20   //Controller loop period in ms
+#define SIM_MAX_SHOTS      8
+#define SIM_SETTLE_BAND    0.02 //Settled/recovered within 2% of the target
+#define SIM_SETTLE_HOLD    200  //ms the velocity must stay in the band to count as settled
+
+//DC motor and flywheel plant
+typedef struct simPlant_t
+{
+	//Motors (per motor, at nominalVoltage)
+	int motorCount;
+	float stallTorque;    //Nm
+	float stallCurrent;   //A
+	float freeSpeed;      //Motor rad/s
+	float nominalVoltage; //V
+
+	//Drivetrain
+	float gearRatio;       //Flywheel revs per motor rev
+	float inertia;         //Flywheel side kg m^2
+	float coulombFriction; //Flywheel side Nm
+	float viscousFriction; //Flywheel side Nm per rad/s
+
+	//Battery
+	float batteryVoltage;    //Open circuit V
+	float batteryResistance; //Internal ohms (sag under load)
+
+	//Sensor
+	float ticksPerRev; //Encoder ticks per flywheel rev
+	float noise;       //Standard deviation of reading noise in ticks
+
+	//Ball shot: the ball's effective inertia about the flywheel axis
+	float ballInertia;
+
+	//State
+	float omega;   //Flywheel rad/s
+	double angle;  //Flywheel rad
+	float current; //Total motor current in A
+	float voltage; //Battery terminal V
+} simPlant;
+
+//Velocity controller under test
+typedef enum
+{
+	SIM_TBH = 0,
+	SIM_PID = 1,
+	SIM_BANGBANG = 2
+} simControllerType;
+
+typedef struct simController_t
+{
+	simControllerType type;
+
+	//TBH: gain, outValApprox; PID: kP, kD; BangBang: highPower, lowPower
+	float gains[2];
+
+	vel_TBH tbh;
+	vel_PID pid;
+	bangBang bb;
+} simController;
+
+//Scripted run
+typedef struct simScenario_t
+{
+	const char *name;
+	int targetRPM;       //Flywheel RPM (what the controllers are given)
+	int duration;        //ms
+	int shotCount;
+	int shots[SIM_MAX_SHOTS]; //ms of each shot
+	float batteryVoltage;     //Overrides the plant's if nonzero
+	unsigned long long seed;  //Noise seed
+} simScenario;
+
+//Metrics of a run
+typedef struct simResult_t
+{
+	float riseTime;   //ms to first reach 90% of the target (duration if never)
+	float overshoot;  //Peak above the target before the first shot, in % of the target
+	float settleTime; //ms when the velocity last entered SIM_SETTLE_BAND before the first shot (duration if it was not held for SIM_SETTLE_HOLD)
+	float recovery;   //Mean ms from a shot back into SIM_SETTLE_BAND
+	float rmsError;   //RMS error in RPM once settled, excluding recoveries
+	float stepNanos;  //Host CPU time per controller step in ns
+	int steps;
+} simResult;
+
+/**
+ * Fills in a 15:1 geared up flywheel driven by two turbo 393 motors
+ *
+ * @param plant The plant
+ */
+void sim_DefaultPlant(simPlant *plant);
+
+/**
+ * Initializes a controller under test
+ *
+ * @param ctrl The controller
+ * @param type Controller type
+ * @param gain0 TBH gain, PID kP, or BangBang high power
+ * @param gain1 TBH open loop approximation, PID kD, or BangBang low power
+ * @param ticksPerRev Encoder ticks per flywheel rev
+ */
+void sim_InitController(simController *ctrl, const simControllerType type, const float gain0, const float gain1, const float ticksPerRev);
+
+/**
+ * Runs a scenario in closed loop
+ *
+ * @param plant Plant parameters (state is reset)
+ * @param ctrl Controller (state is reset)
+ * @param scenario The scenario
+ * @param result Metrics of the run
+ * @param trace Called every plant step with (ms, flywheel RPM, output) if not NULL
+ */
+void sim_Run(simPlant *plant, simController *ctrl, const simScenario *scenario, simResult *result, void (*trace)(int, float, int));
+
+#endif
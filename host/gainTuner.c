@@ -0,0 +1,344 @@
+#include <stdlib.h>
+#include <string.h>
+#include "hostAPI.h"
+#include "flywheelSim.h"
+#include "workPool.h"
+#include "math.h"
+
+/*
+ * Searches controller gains on the flywheel simulation and prints the settle time vs overshoot trade-off
+ * Usage: gainTuner [-c tbh|pid|bangbang] [-m grid|random|nm] [-n evaluations] [-s seeds] [-j threads]
+ *   -c  Controller (default tbh)
+ *   -m  Grid search, random search, or Nelder-Mead runs from random starts with varied weights (default grid)
+ *   -n  Gain sets to evaluate (default 1024)
+ *   -s  Noise seeds per gain set (default 4)
+ *   -j  Threads (default one per processor)
+ * Prints every Pareto-optimal gain set: none of the others settles sooner without overshooting more
+ */
+
+//Nelder-Mead
+#define NM_EVALUATIONS 64   //Evaluations per run
+#define NM_PENALTY     50.0 //ms per % overshoot at the middle weight
+
+//Gain ranges searched (log scale when the low end is positive and the range spans decades)
+typedef struct gainRange_t
+{
+	const char *name;
+	float low;
+	float high;
+	int logScale;
+} gainRange;
+
+static const gainRange ranges[][2] = {
+	{{"gain", 0.001, 0.2, 1}, {"approx", 40, 127, 0}},
+	{{"kP", 0.0005, 0.05, 1}, {"kD", 0, 40, 0}},
+	{{"high", 80, 127, 0}, {"low", 0, 110, 0}}
+};
+
+//Scenario every gain set is scored on: spin-up, then two shots
+static const simScenario tuneScenario = {"tune", 2500, 8000, 2, {5000, 6500}, 0, 1};
+
+//One evaluated gain set
+typedef struct evaluation_t
+{
+	float gains[2];
+	float settle;
+	float overshoot;
+	float recovery;
+	int pareto;
+} evaluation;
+
+typedef struct tuner_t
+{
+	simControllerType type;
+	int seeds;
+	int gridSide;
+	int method;
+	evaluation *evaluations;
+} tuner;
+
+/**
+ * Maps a point in the unit square to gains
+ */
+static void tunerGains(const tuner *t, const float *unit, float *gains)
+{
+	for (int i = 0; i < 2; i++)
+	{
+		const gainRange *r = &(ranges[t->type][i]);
+		const float u = unit[i] < 0 ? 0 : (unit[i] > 1 ? 1 : unit[i]);
+
+		gains[i] = r->logScale ? r->low * powf(r->high / r->low, u) : r->low + (r->high - r->low) * u;
+	}
+}
+
+/**
+ * Scores a gain set over every noise seed
+ */
+static void tunerEvaluate(const tuner *t, const float *unit, evaluation *e)
+{
+	simPlant plant;
+	simController ctrl;
+	simResult result;
+	simScenario scenario = tuneScenario;
+
+	sim_DefaultPlant(&plant);
+	tunerGains(t, unit, e->gains);
+	sim_InitController(&ctrl, t->type, e->gains[0], e->gains[1], plant.ticksPerRev);
+
+	e->settle = e->overshoot = e->recovery = 0;
+	e->pareto = 0;
+
+	for (int s = 0; s < t->seeds; s++)
+	{
+		scenario.seed = s + 1;
+		sim_Run(&plant, &ctrl, &scenario, &result, NULL);
+
+		e->settle += result.settleTime / t->seeds;
+		e->overshoot += result.overshoot / t->seeds;
+		e->recovery += result.recovery / t->seeds;
+	}
+}
+
+/**
+ * One Nelder-Mead run over the unit square, minimizing settle + weight * overshoot
+ * Every evaluation is kept for the Pareto front
+ */
+static void tunerNelderMead(const tuner *t, const int run, const int runs, evaluation *out)
+{
+	const float weight = NM_PENALTY * powf(10, 2.0f * run / (runs > 1 ? runs - 1 : 1) - 1);
+	float simplex[3][2], cost[3];
+	int used = 0;
+
+	#define NM_COST(e) ((e)->settle + weight * (e)->overshoot)
+
+	host_SeedRandom(run + 1);
+
+	for (int i = 0; i < 3; i++)
+	{
+		simplex[i][0] = host_RandomUniform();
+		simplex[i][1] = host_RandomUniform();
+		tunerEvaluate(t, simplex[i], &(out[used]));
+		cost[i] = NM_COST(&(out[used]));
+		used++;
+	}
+
+	while (used + 2 <= NM_EVALUATIONS)
+	{
+		//Order best to worst
+		for (int i = 0; i < 2; i++)
+		{
+			for (int j = 0; j < 2 - i; j++)
+			{
+				if (cost[j] > cost[j + 1])
+				{
+					float tmp = cost[j]; cost[j] = cost[j + 1]; cost[j + 1] = tmp;
+					for (int k = 0; k < 2; k++)
+					{
+						tmp = simplex[j][k]; simplex[j][k] = simplex[j + 1][k]; simplex[j + 1][k] = tmp;
+					}
+				}
+			}
+		}
+
+		//Reflect the worst point through the centroid of the others
+		float centroid[2], reflected[2], trial[2];
+
+		for (int k = 0; k < 2; k++)
+		{
+			centroid[k] = (simplex[0][k] + simplex[1][k]) / 2;
+			reflected[k] = centroid[k] + (centroid[k] - simplex[2][k]);
+		}
+
+		tunerEvaluate(t, reflected, &(out[used]));
+		const float reflectedCost = NM_COST(&(out[used]));
+		used++;
+
+		if (reflectedCost < cost[0])
+		{
+			//Expand
+			for (int k = 0; k < 2; k++)
+			{
+				trial[k] = centroid[k] + 2 * (centroid[k] - simplex[2][k]);
+			}
+
+			tunerEvaluate(t, trial, &(out[used]));
+			const float trialCost = NM_COST(&(out[used]));
+			used++;
+
+			memcpy(simplex[2], trialCost < reflectedCost ? trial : reflected, sizeof(trial));
+			cost[2] = trialCost < reflectedCost ? trialCost : reflectedCost;
+		}
+		else if (reflectedCost < cost[1])
+		{
+			memcpy(simplex[2], reflected, sizeof(reflected));
+			cost[2] = reflectedCost;
+		}
+		else
+		{
+			//Contract toward the centroid
+			for (int k = 0; k < 2; k++)
+			{
+				trial[k] = centroid[k] + 0.5f * (simplex[2][k] - centroid[k]);
+			}
+
+			tunerEvaluate(t, trial, &(out[used]));
+			const float trialCost = NM_COST(&(out[used]));
+			used++;
+
+			if (trialCost < cost[2])
+			{
+				memcpy(simplex[2], trial, sizeof(trial));
+				cost[2] = trialCost;
+			}
+			else
+			{
+				//Shrink toward the best point
+				if (used + 2 > NM_EVALUATIONS)
+				{
+					break;
+				}
+
+				for (int i = 1; i < 3; i++)
+				{
+					for (int k = 0; k < 2; k++)
+					{
+						simplex[i][k] = simplex[0][k] + 0.5f * (simplex[i][k] - simplex[0][k]);
+					}
+
+					tunerEvaluate(t, simplex[i], &(out[used]));
+					cost[i] = NM_COST(&(out[used]));
+					used++;
+				}
+			}
+		}
+	}
+
+	#undef NM_COST
+
+	//Unused slots repeat the last evaluation so every run fills its block
+	for (int i = used; i < NM_EVALUATIONS; i++)
+	{
+		out[i] = out[used - 1];
+	}
+}
+
+/**
+ * Pool job: one gain set (grid, random) or one optimizer run (Nelder-Mead)
+ */
+static void tunerJob(void *context, int job, int worker)
+{
+	tuner *t = context;
+	float unit[2];
+
+	switch (t->method)
+	{
+		case 0:
+			unit[0] = (job % t->gridSide) / (float)(t->gridSide - 1);
+			unit[1] = (job / t->gridSide) / (float)(t->gridSide - 1);
+			tunerEvaluate(t, unit, &(t->evaluations[job]));
+			break;
+
+		case 1:
+			host_SeedRandom(job + 1);
+			unit[0] = host_RandomUniform();
+			unit[1] = host_RandomUniform();
+			tunerEvaluate(t, unit, &(t->evaluations[job]));
+			break;
+
+		default:
+			tunerNelderMead(t, job, t->gridSide, &(t->evaluations[job * NM_EVALUATIONS]));
+			break;
+	}
+}
+
+static int compareSettle(const void *a, const void *b)
+{
+	const evaluation *x = a, *y = b;
+	return x->settle < y->settle ? -1 : (x->settle > y->settle ? 1 : (x->overshoot > y->overshoot) - (x->overshoot < y->overshoot));
+}
+
+int main(int argc, char **argv)
+{
+	tuner t = {SIM_TBH, 4, 0, 0, NULL};
+	int evaluations = 1024, threads = 0;
+
+	for (int i = 1; i + 1 < argc; i += 2)
+	{
+		if (strcmp(argv[i], "-c") == 0)
+		{
+			t.type = strcmp(argv[i + 1], "pid") == 0 ? SIM_PID : (strcmp(argv[i + 1], "bangbang") == 0 ? SIM_BANGBANG : SIM_TBH);
+		}
+		else if (strcmp(argv[i], "-m") == 0)
+		{
+			t.method = strcmp(argv[i + 1], "random") == 0 ? 1 : (strcmp(argv[i + 1], "nm") == 0 ? 2 : 0);
+		}
+		else if (strcmp(argv[i], "-n") == 0)
+		{
+			evaluations = atoi(argv[i + 1]);
+		}
+		else if (strcmp(argv[i], "-s") == 0)
+		{
+			t.seeds = atoi(argv[i + 1]);
+		}
+		else if (strcmp(argv[i], "-j") == 0)
+		{
+			threads = atoi(argv[i + 1]);
+		}
+	}
+
+	//Jobs: grid points, random points, or optimizer runs (gridSide holds the run count)
+	int jobs;
+
+	if (t.method == 0)
+	{
+		t.gridSide = 2;
+
+		while ((t.gridSide + 1) * (t.gridSide + 1) <= evaluations)
+		{
+			t.gridSide++;
+		}
+
+		jobs = evaluations = t.gridSide * t.gridSide;
+	}
+	else if (t.method == 1)
+	{
+		jobs = evaluations;
+	}
+	else
+	{
+		jobs = t.gridSide = evaluations / NM_EVALUATIONS > 0 ? evaluations / NM_EVALUATIONS : 1;
+		evaluations = jobs * NM_EVALUATIONS;
+	}
+
+	t.evaluations = calloc(evaluations, sizeof(evaluation));
+	threads = threads <= 0 ? pool_DefaultThreads() : threads;
+
+	const unsigned long long start = host_WallNanos();
+	const int steals = pool_Run(threads, jobs, tunerJob, &t);
+	const double seconds = (host_WallNanos() - start) / 1e9;
+
+	//Pareto front: sorted by settle time, keep each set which overshoots less than every faster one
+	qsort(t.evaluations, evaluations, sizeof(evaluation), compareSettle);
+
+	const gainRange *r = ranges[t.type];
+	float bestOvershoot = 1e30;
+
+	printf("%10s %10s %10s %10s %10s\n", r[0].name, r[1].name, "settle ms", "overshoot", "recovery");
+
+	for (int i = 0; i < evaluations; i++)
+	{
+		evaluation *e = &(t.evaluations[i]);
+
+		if (e->overshoot < bestOvershoot && e->settle < tuneScenario.shots[0])
+		{
+			bestOvershoot = e->overshoot;
+			printf("%10.4g %10.4g %10.0f %9.2f%% %10.0f\n", e->gains[0], e->gains[1], e->settle, e->overshoot, e->recovery);
+		}
+	}
+
+	printf("# %d gain sets x %d seeds on %d threads in %.2f s (%.0f runs/s, %d steals)\n", evaluations, t.seeds, threads,
+		seconds, evaluations * t.seeds / seconds, steals);
+
+	free(t.evaluations);
+	return 0;
+}
@@ -0,0 +1,442 @@
+#include <time.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include "hostAPI.h"
+#include "math.h"
+
+//Virtual clock in microseconds (per thread, so simulations can run in parallel)
+static __thread unsigned long hostMicros = 0;
+
+//Loops started with taskRunLoop, run by host_RunTasks
+#define HOST_MAX_LOOPS 16
+static void (*hostLoopFns[HOST_MAX_LOOPS])(void);
+static unsigned long hostLoopPeriods[HOST_MAX_LOOPS];
+static unsigned long hostLoopNext[HOST_MAX_LOOPS];
+static int hostLoopCount = 0;
+
+//Last power sent to each motor port
+static int hostMotors[10];
+
+//Analog readings, digital pin states, and IMEs
+static int hostAnalog[BOARD_NR_ADC_PINS + 1];
+static bool hostDigital[BOARD_NR_GPIO_PINS + 1];
+static int hostIMECount[IME_ADDR_MAX + 1];
+static int hostIMEVelocity[IME_ADDR_MAX + 1];
+static bool hostIMEPresent[IME_ADDR_MAX + 1];
+
+//Joystick axes and buttons (one bit per button, four per group from group 5)
+static int hostJoystickAnalog[2][4];
+static unsigned short hostJoystickDigital[2];
+
+//Main battery voltage in mV
+static unsigned int hostBattery = 7800;
+
+//Host file descriptors behind uart1 and uart2
+static int hostSerialFds[3] = {-1, -1, -1};
+
+//Random number generator state (per thread)
+static __thread unsigned long long hostRandomState = 0x9E3779B97F4A7C15ULL;
+
+/**
+ * Sets the virtual clock
+ *
+ * @param us New time in microseconds
+ */
+void host_SetMicros(const unsigned long us)
+{
+	hostMicros = us;
+}
+
+/**
+ * Advances the virtual clock
+ *
+ * @param us Time to advance in microseconds
+ */
+void host_AdvanceMicros(const unsigned long us)
+{
+	hostMicros += us;
+}
+
+/**
+ * Sets the main battery voltage reported by powerLevelMain()
+ *
+ * @param mv Voltage in mV
+ */
+void host_SetBattery(const unsigned int mv)
+{
+	hostBattery = mv;
+}
+
+/**
+ * Sets the value read from an analog channel
+ *
+ * @param channel Analog channel (1 to BOARD_NR_ADC_PINS)
+ * @param value Reading (0 to 4095)
+ */
+void host_SetAnalog(const unsigned char channel, const int value)
+{
+	hostAnalog[channel] = value;
+}
+
+/**
+ * Sets the value read from a digital pin
+ *
+ * @param pin Digital pin
+ * @param value Pin state
+ */
+void host_SetDigital(const unsigned char pin, const bool value)
+{
+	hostDigital[pin] = value;
+}
+
+/**
+ * Sets an IME's count and velocity (IMEs which were never set fail to read)
+ *
+ * @param address IME address
+ * @param count Count
+ * @param velocity Velocity
+ */
+void host_SetIME(const unsigned char address, const int count, const int velocity)
+{
+	hostIMECount[address] = count;
+	hostIMEVelocity[address] = velocity;
+	hostIMEPresent[address] = true;
+}
+
+/**
+ * Sets the value read from a joystick axis
+ *
+ * @param joystick Joystick (1 or 2)
+ * @param axis Axis (1 to 4)
+ * @param value Reading (-127 to 127)
+ */
+void host_SetJoystickAnalog(const unsigned char joystick, const unsigned char axis, const int value)
+{
+	hostJoystickAnalog[joystick - 1][axis - 1] = value;
+}
+
+/**
+ * Sets whether a joystick button is pressed
+ *
+ * @param joystick Joystick (1 or 2)
+ * @param group Button group (5 to 8)
+ * @param button JOY_DOWN, JOY_LEFT, JOY_UP, or JOY_RIGHT
+ * @param pressed Button state
+ */
+void host_SetJoystickDigital(const unsigned char joystick, const unsigned char group, const unsigned char button, const bool pressed)
+{
+	const unsigned short bit = (unsigned short)button << ((group - 5) * 4);
+	hostJoystickDigital[joystick - 1] = pressed ? hostJoystickDigital[joystick - 1] | bit : hostJoystickDigital[joystick - 1] & ~bit;
+}
+
+/**
+ * Attaches a UART to a host file descriptor (e.g. a pty or a file)
+ *
+ * @param port uart1 or uart2
+ * @param fd Open file descriptor, or -1 to detach
+ */
+void host_SetSerialFd(FILE *port, const int fd)
+{
+	hostSerialFds[(unsigned long)port] = fd;
+}
+
+/**
+ * Runs every taskRunLoop loop which is due at the current virtual time
+ */
+void host_RunTasks()
+{
+	for (int i = 0; i < hostLoopCount; i++)
+	{
+		if (hostMicros >= hostLoopNext[i])
+		{
+			hostLoopNext[i] += hostLoopPeriods[i];
+			hostLoopFns[i]();
+		}
+	}
+}
+
+/**
+ * Gets the host's real monotonic clock in nanoseconds, for timing code under test
+ */
+unsigned long long host_WallNanos()
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (unsigned long long)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+/**
+ * Seeds the deterministic random number generator
+ *
+ * @param seed New seed (nonzero)
+ */
+void host_SeedRandom(const unsigned long long seed)
+{
+	hostRandomState = seed == 0 ? 1 : seed;
+}
+
+/**
+ * Gets a uniformly distributed random number in [0, 1)
+ */
+float host_RandomUniform()
+{
+	//xorshift64*
+	hostRandomState ^= hostRandomState >> 12;
+	hostRandomState ^= hostRandomState << 25;
+	hostRandomState ^= hostRandomState >> 27;
+	return ((hostRandomState * 0x2545F4914F6CDD1DULL) >> 40) / 16777216.0f;
+}
+
+/**
+ * Gets a normally distributed random number with zero mean and unit variance
+ */
+float host_RandomGaussian()
+{
+	//Box-Muller
+	const float u1 = host_RandomUniform() + 1e-7f;
+	const float u2 = host_RandomUniform();
+	return sqrtf(-2.0f * logf(u1)) * cosf(2.0f * PI * u2);
+}
+
+// -------------------- PROS API --------------------
+
+unsigned long micros()
+{
+	return hostMicros;
+}
+
+unsigned long millis()
+{
+	return hostMicros / 1000;
+}
+
+void delay(const unsigned long time)
+{
+	hostMicros += time * 1000;
+}
+
+void wait(const unsigned long time)
+{
+	delay(time);
+}
+
+void taskDelay(const unsigned long msToDelay)
+{
+	delay(msToDelay);
+}
+
+void taskDelayUntil(unsigned long *previousWakeTime, const unsigned long cycleTime)
+{
+	*previousWakeTime += cycleTime;
+
+	if ((long)(*previousWakeTime - millis()) > 0)
+	{
+		delay(*previousWakeTime - millis());
+	}
+}
+
+TaskHandle taskCreate(TaskCode taskCode, const unsigned int stackDepth, void *parameters, const unsigned int priority)
+{
+	//Free-running tasks are not simulated; host programs step the work explicitly
+	return NULL;
+}
+
+TaskHandle taskRunLoop(void (*fn)(void), const unsigned long increment)
+{
+	if (hostLoopCount >= HOST_MAX_LOOPS)
+	{
+		return NULL;
+	}
+
+	hostLoopFns[hostLoopCount] = fn;
+	hostLoopPeriods[hostLoopCount] = increment * 1000;
+	hostLoopNext[hostLoopCount] = hostMicros;
+	hostLoopCount++;
+
+	return (TaskHandle)fn;
+}
+
+int encoderGet(Encoder enc)
+{
+	return *(int *)enc;
+}
+
+int gyroGet(Gyro gyro)
+{
+	return *(int *)gyro;
+}
+
+int analogRead(unsigned char channel)
+{
+	return channel <= BOARD_NR_ADC_PINS ? hostAnalog[channel] : 0;
+}
+
+int joystickGetAnalog(unsigned char joystick, unsigned char axis)
+{
+	return joystick >= 1 && joystick <= 2 && axis >= 1 && axis <= 4 ? hostJoystickAnalog[joystick - 1][axis - 1] : 0;
+}
+
+bool joystickGetDigital(unsigned char joystick, unsigned char buttonGroup, unsigned char button)
+{
+	if (joystick < 1 || joystick > 2 || buttonGroup < 5 || buttonGroup > 8)
+	{
+		return false;
+	}
+
+	return (hostJoystickDigital[joystick - 1] & ((unsigned short)button << ((buttonGroup - 5) * 4))) != 0;
+}
+
+int analogCalibrate(unsigned char channel)
+{
+	//The simulated reading is noiseless, so one sample is its average
+	return analogRead(channel);
+}
+
+int analogReadCalibratedHR(unsigned char channel)
+{
+	//16 times the resolution, as on the robot
+	return analogRead(channel) * 16;
+}
+
+bool digitalRead(unsigned char pin)
+{
+	return pin <= BOARD_NR_GPIO_PINS ? hostDigital[pin] : false;
+}
+
+unsigned int imeInitializeAll()
+{
+	unsigned int count = 0;
+
+	//Addresses are handed out along the chain, so stop at the first gap
+	while (count <= IME_ADDR_MAX && hostIMEPresent[count])
+	{
+		count++;
+	}
+
+	return count;
+}
+
+bool imeGet(unsigned char address, int *value)
+{
+	if (address > IME_ADDR_MAX || !hostIMEPresent[address])
+	{
+		return false;
+	}
+
+	*value = hostIMECount[address];
+	return true;
+}
+
+bool imeGetVelocity(unsigned char address, int *value)
+{
+	if (address > IME_ADDR_MAX || !hostIMEPresent[address])
+	{
+		return false;
+	}
+
+	*value = hostIMEVelocity[address];
+	return true;
+}
+
+int motorGet(unsigned char channel)
+{
+	return hostMotors[channel];
+}
+
+void motorSet(unsigned char channel, int speed)
+{
+	hostMotors[channel] = speed;
+}
+
+unsigned int powerLevelMain()
+{
+	return hostBattery;
+}
+
+void usartInit(FILE *usart, unsigned int baud, unsigned int flags)
+{
+	//Baud rate and framing belong to whatever is on the other end of the file descriptor
+}
+
+//Whether a FILE pointer is one of the UART ports rather than a host C library stream
+static int hostSerialPort(FILE *stream)
+{
+	return stream == uart1 || stream == uart2;
+}
+
+size_t __real_fwrite(const void *ptr, size_t size, size_t count, FILE *stream);
+int __real_fgetc(FILE *stream);
+
+size_t __wrap_fwrite(const void *ptr, size_t size, size_t count, FILE *stream)
+{
+	if (!hostSerialPort(stream))
+	{
+		return __real_fwrite(ptr, size, count, stream);
+	}
+
+	const int fd = hostSerialFds[(unsigned long)stream];
+
+	if (fd < 0 || size == 0)
+	{
+		return 0;
+	}
+
+	const ssize_t written = write(fd, ptr, size * count);
+	return written < 0 ? 0 : written / size;
+}
+
+int __wrap_fgetc(FILE *stream)
+{
+	if (!hostSerialPort(stream))
+	{
+		return __real_fgetc(stream);
+	}
+
+	unsigned char c;
+	const int fd = hostSerialFds[(unsigned long)stream];
+
+	return fd >= 0 && read(fd, &c, 1) == 1 ? c : -1;
+}
+
+int fcount(FILE *stream)
+{
+	int available = 0;
+	const int fd = hostSerialFds[(unsigned long)stream];
+
+	if (!hostSerialPort(stream) || fd < 0 || ioctl(fd, FIONREAD, &available) < 0)
+	{
+		return 0;
+	}
+
+	return available;
+}
+
+unsigned int lcdReadButtons(FILE *lcdPort)
+{
+	//No buttons are ever pressed
+	return 0;
+}
+
+void lcdPrint(FILE *lcdPort, unsigned char line, const char *formatString, ...)
+{
+}
+
+void lcdSetText(FILE *lcdPort, unsigned char line, const char *buffer)
+{
+}
+
+Mutex mutexCreate()
+{
+	//Library code is only ever run from one thread at a time, so any non-NULL handle will do
+	return (Mutex)&hostBattery;
+}
+
+bool mutexTake(Mutex mutex, const unsigned long blockTime)
+{
+	return true;
+}
+
+bool mutexGive(Mutex mutex)
+{
+	return true;
+}
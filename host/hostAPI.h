@@ -0,0 +1,118 @@
+#ifndef HOSTAPI_H_
+#define HOSTAPI_H_
+
+#include "API.h"
+
+/*
+ * Host stand-ins for the parts of the PROS API used by the library, so library sources can be
+ * compiled and exercised on a development machine
+ *
+ * Time is virtual and only moves when advanced (or when delay() is called)
+ * The clock and the random number generator are per thread, so independent simulations can run in parallel
+ * Encoder and Gyro handles point at an int holding the current reading
+ * motorSet() values are kept and read back with motorGet()
+ * File functions are the host C library's (FILE is only ever used through pointers)
+ * uart1 and uart2 can be attached to host file descriptors (programs link with --wrap=fwrite,--wrap=fgetc)
+ */
+
+/**
+ * Sets the virtual clock
+ *
+ * @param us New time in microseconds
+ */
+void host_SetMicros(const unsigned long us);
+
+/**
+ * Advances the virtual clock
+ *
+ * @param us Time to advance in microseconds
+ */
+void host_AdvanceMicros(const unsigned long us);
+
+/**
+ * Sets the main battery voltage reported by powerLevelMain()
+ *
+ * @param mv Voltage in mV
+ */
+void host_SetBattery(const unsigned int mv);
+
+/**
+ * Sets the value read from an analog channel
+ *
+ * @param channel Analog channel (1 to BOARD_NR_ADC_PINS)
+ * @param value Reading (0 to 4095)
+ */
+void host_SetAnalog(const unsigned char channel, const int value);
+
+/**
+ * Sets the value read from a digital pin
+ *
+ * @param pin Digital pin
+ * @param value Pin state
+ */
+void host_SetDigital(const unsigned char pin, const bool value);
+
+/**
+ * Sets an IME's count and velocity (IMEs which were never set fail to read)
+ *
+ * @param address IME address
+ * @param count Count
+ * @param velocity Velocity
+ */
+void host_SetIME(const unsigned char address, const int count, const int velocity);
+
+/**
+ * Sets the value read from a joystick axis
+ *
+ * @param joystick Joystick (1 or 2)
+ * @param axis Axis (1 to 4)
+ * @param value Reading (-127 to 127)
+ */
+void host_SetJoystickAnalog(const unsigned char joystick, const unsigned char axis, const int value);
+
+/**
+ * Sets whether a joystick button is pressed
+ *
+ * @param joystick Joystick (1 or 2)
+ * @param group Button group (5 to 8)
+ * @param button JOY_DOWN, JOY_LEFT, JOY_UP, or JOY_RIGHT
+ * @param pressed Button state
+ */
+void host_SetJoystickDigital(const unsigned char joystick, const unsigned char group, const unsigned char button, const bool pressed);
+
+/**
+ * Attaches a UART to a host file descriptor (e.g. a pty or a file)
+ *
+ * @param port uart1 or uart2
+ * @param fd Open file descriptor, or -1 to detach
+ */
+void host_SetSerialFd(FILE *port, const int fd);
+
+/**
+ * Runs every taskRunLoop loop which is due at the current virtual time
+ */
+void host_RunTasks();
+
+/**
+ * Gets the host's real monotonic clock in nanoseconds, for timing code under test
+ */
+unsigned long long host_WallNanos();
+
+/**
+ * Seeds the deterministic random number generator
+ *
+ * @param seed New seed (nonzero)
+ */
+void host_SeedRandom(const unsigned long long seed);
+
+/**
+ * Gets a uniformly distributed random number in [0, 1)
+ */
+float host_RandomUniform();
+
+/**
+ * Gets a normally distributed random number with zero mean and unit variance
+ */
+float host_RandomGaussian();
+
+#endif
@@ -0,0 +1,225 @@
+#include <stdlib.h>
+#include <string.h>
+#include "hostAPI.h"
+#include "bangBang.h"
+#include "positionPID.h"
+#include "telemetry.h"
+#include "velocityPID.h"
+#include "velocityTBH.h"
+
+/*
+ * Replays a telemetry log through a controller on the virtual clock and diffs its outputs against the recorded ones
+ * Usage: logReplay [-v] <log file> <controller> <sensor ch> <output ch> <target ch or -> <gain> <gain> <gain>
+ *   controller  tbh (gain, outValApprox, ticksPerRev), velpid (kP, kD, ticksPerRev),
+ *               bangbang (highPower, lowPower, ticksPerRev), or pospid (kP, kI, kD)
+ *   -v          Print every step as CSV (time,sensor,target,recorded,replayed)
+ * Exits nonzero if any replayed output differs from the recorded one
+ *
+ * Log each step on the robot with the controller's own step time so the replay runs at the same times:
+ *   out = vel_TBH_StepController(&tbh, sens);
+ *   telemetry_PushAt(tbh.prevTime, SENSOR_CH, sens);
+ *   telemetry_PushAt(tbh.prevTime, OUTPUT_CH, out);
+ */
+
+#define REPLAY_CHUNK 4096 //Records read at a time, so log size does not matter
+
+typedef enum
+{
+	REPLAY_TBH,
+	REPLAY_VEL_PID,
+	REPLAY_BANGBANG,
+	REPLAY_POS_PID
+} replayType;
+
+typedef struct replayController_t
+{
+	replayType type;
+	vel_TBH tbh;
+	vel_PID vpid;
+	bangBang bb;
+	pos_PID ppid;
+} replayController;
+
+static void replaySetTarget(replayController *c, const float target)
+{
+	switch (c->type)
+	{
+		case REPLAY_TBH:
+			vel_TBH_SetTargetVelocity(&(c->tbh), target, -1010);
+			break;
+
+		case REPLAY_VEL_PID:
+			vel_PID_SetTargetVelocity(&(c->vpid), target);
+			break;
+
+		case REPLAY_BANGBANG:
+			bangBang_SetTargetVelocity(&(c->bb), target);
+			break;
+
+		case REPLAY_POS_PID:
+			pos_PID_SetTargetPosition(&(c->ppid), target);
+			break;
+	}
+}
+
+static int replayStep(replayController *c, const float sens)
+{
+	switch (c->type)
+	{
+		case REPLAY_TBH:
+			return vel_TBH_StepController(&(c->tbh), sens);
+
+		case REPLAY_VEL_PID:
+			return vel_PID_StepController(&(c->vpid), sens);
+
+		case REPLAY_BANGBANG:
+			return bangBang_StepController(&(c->bb), sens);
+
+		default:
+			return pos_PID_StepController(&(c->ppid), sens);
+	}
+}
+
+int main(int argc, char **argv)
+{
+	int arg = 1;
+	bool verbose = false;
+
+	if (argc > 1 && strcmp(argv[1], "-v") == 0)
+	{
+		verbose = true;
+		arg++;
+	}
+
+	if (argc - arg < 8)
+	{
+		printf("usage: %s [-v] <log file> <tbh|velpid|bangbang|pospid> <sensor ch> <output ch> <target ch or -> <gain> <gain> <gain>\n", argv[0]);
+		return 1;
+	}
+
+	FILE *f = fopen(argv[arg], "rb");
+
+	if (f == NULL)
+	{
+		printf("could not open %s\n", argv[arg]);
+		return 1;
+	}
+
+	telemetryHeader header;
+
+	if (fread(&header, sizeof(header), 1, f) != 1 || header.magic != TELEMETRY_MAGIC || header.version != TELEMETRY_VERSION || header.recordSize != sizeof(telemetryRecord))
+	{
+		printf("%s is not a supported telemetry log\n", argv[arg]);
+		return 1;
+	}
+
+	const char *type = argv[arg + 1];
+	const int sensorCh = atoi(argv[arg + 2]);
+	const int outputCh = atoi(argv[arg + 3]);
+	const int targetCh = strcmp(argv[arg + 4], "-") == 0 ? -1 : atoi(argv[arg + 4]);
+	const float g0 = atof(argv[arg + 5]), g1 = atof(argv[arg + 6]), g2 = atof(argv[arg + 7]);
+
+	//Controller as it was initialized on the robot
+	replayController c;
+
+	if (strcmp(type, "tbh") == 0)
+	{
+		c.type = REPLAY_TBH;
+		vel_TBH_InitController(&(c.tbh), g0, g1, g2);
+	}
+	else if (strcmp(type, "velpid") == 0)
+	{
+		c.type = REPLAY_VEL_PID;
+		vel_PID_InitController(&(c.vpid), g0, g1, g2);
+	}
+	else if (strcmp(type, "bangbang") == 0)
+	{
+		c.type = REPLAY_BANGBANG;
+		bangBang_InitController(&(c.bb), g0, g1, g2);
+	}
+	else if (strcmp(type, "pospid") == 0)
+	{
+		c.type = REPLAY_POS_PID;
+		pos_PID_InitController(&(c.ppid), g0, g1, g2);
+	}
+	else
+	{
+		printf("unknown controller %s\n", type);
+		return 1;
+	}
+
+	static telemetryRecord chunk[REPLAY_CHUNK];
+	unsigned long records = 0, steps = 0, compared = 0, mismatches = 0, gaps = 0;
+	unsigned short expected = 0;
+	float target = 0, sensor = 0;
+	int replayed = 0;
+	bool pending = false;
+	size_t n;
+
+	const unsigned long long start = host_WallNanos();
+
+	if (verbose)
+	{
+		printf("time,sensor,target,recorded,replayed\n");
+	}
+
+	while ((n = fread(chunk, sizeof(telemetryRecord), REPLAY_CHUNK, f)) > 0)
+	{
+		for (size_t i = 0; i < n; i++)
+		{
+			const telemetryRecord *r = &(chunk[i]);
+
+			if (r->channel == TELEMETRY_CH_DROPPED)
+			{
+				continue;
+			}
+
+			//A gap means steps may be missing, so outputs after it can legitimately differ
+			if (records > 0 && r->sequence != expected)
+			{
+				gaps++;
+			}
+
+			expected = r->sequence + 1;
+			records++;
+
+			if (r->channel == targetCh)
+			{
+				target = r->value;
+				replaySetTarget(&c, target);
+			}
+			else if (r->channel == sensorCh)
+			{
+				host_SetMicros((unsigned long)r->time * 1000);
+				sensor = r->value;
+				replayed = replayStep(&c, sensor);
+				pending = true;
+				steps++;
+			}
+			else if (r->channel == outputCh && pending)
+			{
+				const bool match = (float)replayed == r->value;
+				pending = false;
+				compared++;
+
+				if (!match && mismatches++ < 10 && !verbose)
+				{
+					printf("mismatch at %u ms: sensor %g, recorded %g, replayed %d\n", r->time, sensor, r->value, replayed);
+				}
+
+				if (verbose)
+				{
+					printf("%u,%g,%g,%g,%d\n", r->time, sensor, target, r->value, replayed);
+				}
+			}
+		}
+	}
+
+	fclose(f);
+
+	const double seconds = (host_WallNanos() - start) / 1e9;
+	printf("# %lu records, %lu steps, %lu outputs compared, %lu mismatched, %lu sequence gaps, %.3f s\n", records, steps, compared,
+		mismatches, gaps, seconds);
+
+	return mismatches > 0 ? 1 : 0;
+}
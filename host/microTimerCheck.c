@@ -0,0 +1,133 @@
+#include "hostAPI.h"
+#include "microTimer.h"
+
+/*
+ * Checks the microsecond timer against a simulated 32-bit clock
+ * Covers micros() wrapping, Stop/Start, and GetDT and Lap measuring independently
+ * Exits nonzero if any check fails
+ */
+
+//Simulated Cortex micros(), which is 32 bits wide
+static unsigned long checkClock = 0;
+
+//Failed checks
+static int checkFailures = 0;
+
+/**
+ * Reads the simulated clock
+ */
+static unsigned long checkMicros()
+{
+	return checkClock & 0xFFFFFFFFUL;
+}
+
+/**
+ * Moves the simulated clock forward
+ *
+ * @param us Time to advance by
+ */
+static void checkAdvance(const unsigned long us)
+{
+	checkClock = (checkClock + us) & 0xFFFFFFFFUL;
+}
+
+/**
+ * Records and prints the outcome of one check
+ *
+ * @param name What was checked
+ * @param got Value the timer returned
+ * @param want Expected value
+ */
+static void checkEqual(const char *name, const unsigned long long got, const unsigned long long want)
+{
+	const bool ok = got == want;
+	checkFailures += !ok;
+
+	printf("%-32s %12llu %12llu%s\n", name, got, want, ok ? "" : "  FAILED");
+}
+
+int main()
+{
+	microTimer mt;
+
+	microTimer_SetClock(checkMicros);
+	printf("check                                     got     expected\n");
+
+	//Laps and elapsed time across the wrap of the 32-bit clock
+	checkClock = 0xFFFFFF00UL;
+	microTimer_Init(&mt);
+
+	for (int i = 0; i < 10; i++)
+	{
+		checkAdvance(100 + i * 10);
+		microTimer_Lap(&mt);
+	}
+
+	checkEqual("wrap: lap count", microTimer_GetLapCount(&mt), 10);
+	checkEqual("wrap: lap min", microTimer_GetLapMin(&mt), 100);
+	checkEqual("wrap: lap max", microTimer_GetLapMax(&mt), 190);
+	checkEqual("wrap: lap mean x10", (unsigned long long)(microTimer_GetLapMean(&mt) * 10 + 0.5), 1450);
+	checkEqual("wrap: elapsed", microTimer_GetElapsed(&mt), 1450);
+
+	//Elapsed time beyond 32 bits, read often enough to see every wrap
+	for (int i = 0; i < 10; i++)
+	{
+		checkAdvance(3000000000UL);
+		microTimer_GetElapsed(&mt);
+	}
+
+	checkEqual("wrap: elapsed past 2^32", microTimer_GetElapsed(&mt), 1450 + 30000000000ULL);
+
+	//Time spent stopped is not counted, and Stop/Start do not disturb laps or dt
+	checkClock = 1000;
+	microTimer_Init(&mt);
+
+	checkAdvance(200);
+	microTimer_Stop(&mt);
+	checkAdvance(5000);
+	microTimer_Stop(&mt);
+	microTimer_Start(&mt);
+	checkAdvance(300);
+
+	checkEqual("stop/start: elapsed", microTimer_GetElapsed(&mt), 500);
+	checkEqual("stop/start: lap", microTimer_Lap(&mt), 5500);
+	checkEqual("stop/start: dt", microTimer_GetDT(&mt), 5500);
+
+	microTimer_Start(&mt);
+	checkAdvance(50);
+	checkEqual("stop/start: start while running", microTimer_GetElapsed(&mt), 550);
+
+	//GetDT and Lap each measure from their own last call
+	checkClock = 0xFFFFFFF0UL;
+	microTimer_Init(&mt);
+
+	checkAdvance(40);
+	checkEqual("independent: dt", microTimer_GetDT(&mt), 40);
+	checkAdvance(60);
+	checkEqual("independent: lap", microTimer_Lap(&mt), 100);
+	checkAdvance(10);
+	checkEqual("independent: dt after lap", microTimer_GetDT(&mt), 70);
+	checkEqual("independent: dt again", microTimer_GetDT(&mt), 0);
+	checkAdvance(25);
+	checkEqual("independent: lap after dt", microTimer_Lap(&mt), 35);
+	checkEqual("independent: lap count", microTimer_GetLapCount(&mt), 2);
+	checkEqual("independent: lap max", microTimer_GetLapMax(&mt), 100);
+
+	//Reset clears the statistics and starts a new lap, but leaves dt alone
+	checkAdvance(15);
+	microTimer_Reset(&mt);
+	checkAdvance(5);
+	checkEqual("reset: elapsed", microTimer_GetElapsed(&mt), 5);
+	checkEqual("reset: lap", microTimer_Lap(&mt), 5);
+	checkEqual("reset: dt", microTimer_GetDT(&mt), 45);
+
+	microTimer_SetClock(NULL);
+
+	if (checkFailures > 0)
+	{
+		printf("%d check(s) failed\n", checkFailures);
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,122 @@
+#include "hostAPI.h"
+#include "odometry.h"
+#include "util.h"
+#include "math.h"
+
+/*
+ * Drives a simulated chassis along a curving path and compares odometry against the true pose
+ * Wheel slip makes the encoders over-count; the gyro only sees quantization and noise
+ */
+
+#define BENCH_DT_MS      ODOM_TASK_DELAY
+#define BENCH_DURATION_S 30
+#define BENCH_WHEEL_DIAM 2.75
+#define BENCH_TRACK      12.0
+#define BENCH_ITERATIONS 1000000
+
+//Simulated sensor readings (handles point at these)
+static int leftTicks, rightTicks, gyroDeg;
+
+/**
+ * Runs one drive with a given slip level
+ *
+ * @param slip Mean fraction of extra wheel travel due to slip
+ * @param useGyro Whether odometry gets the gyro
+ * @param maxErr Largest position error seen (output)
+ * @param headingErr Final heading error in degrees (output)
+ * @return Final position error in inches
+ */
+static float runDrive(const float slip, const bool useGyro, float *maxErr, float *headingErr)
+{
+	const float dt = BENCH_DT_MS / 1000.0;
+	const float inchesPerTick = (PI * BENCH_WHEEL_DIAM) / UTIL_QUAD_TPR;
+
+	float x = 0, y = 0, theta = 0, prevV = 0;
+	float leftTravel = 0, rightTravel = 0;
+	odomPose pose;
+
+	host_SeedRandom(1234);
+	host_SetMicros(0);
+	leftTicks = rightTicks = gyroDeg = 0;
+	odom_Init((Encoder)&leftTicks, (Encoder)&rightTicks, useGyro ? (Gyro)&gyroDeg : NULL, BENCH_WHEEL_DIAM, BENCH_TRACK);
+
+	*maxErr = 0;
+
+	for (int step = 0; step < BENCH_DURATION_S * 1000 / BENCH_DT_MS; step++)
+	{
+		const float t = step * dt;
+
+		//Accelerate, cruise, and weave
+		const float v = 40.0 * (t < 2.0 ? t / 2.0 : 1.0) * (0.75 + 0.25 * sinf(t * 0.7));
+		const float w = 1.2 * sinf(t * 0.9);
+		const float accel = fabsf(v - prevV) / dt;
+		prevV = v;
+
+		//True wheel travel
+		const float dL = (v - w * BENCH_TRACK * 0.5) * dt;
+		const float dR = (v + w * BENCH_TRACK * 0.5) * dt;
+
+		//Wheels slip more while accelerating
+		const float slipL = slip * (fabsf(host_RandomGaussian()) + accel / 40.0);
+		const float slipR = slip * (fabsf(host_RandomGaussian()) + accel / 40.0);
+		leftTravel += dL * (1.0 + slipL);
+		rightTravel += dR * (1.0 + slipR);
+
+		//True pose
+		x += ((dL + dR) * 0.5) * cosf(theta + w * dt * 0.5);
+		y += ((dL + dR) * 0.5) * sinf(theta + w * dt * 0.5);
+		theta += w * dt;
+
+		//Sensors
+		leftTicks = (int)floorf(leftTravel / inchesPerTick);
+		rightTicks = (int)floorf(rightTravel / inchesPerTick);
+		gyroDeg = (int)lroundf(theta * 180.0 / PI + 0.2 * host_RandomGaussian());
+
+		host_AdvanceMicros(BENCH_DT_MS * 1000);
+		odom_Update();
+
+		odom_GetPose(&pose);
+		const float err = hypotf(pose.x - x, pose.y - y);
+		*maxErr = err > *maxErr ? err : *maxErr;
+	}
+
+	*headingErr = (pose.theta - theta) * 180.0 / PI;
+	return hypotf(pose.x - x, pose.y - y);
+}
+
+int main()
+{
+	const float slips[] = {0.0, 0.02, 0.05, 0.10};
+
+	printf("Accuracy over a %ds drive (inches, degrees)\n", BENCH_DURATION_S);
+	printf("%6s %10s %10s %10s %10s %10s %10s\n", "slip", "gyroFinal", "gyroMax", "gyroHdg", "encFinal", "encMax", "encHdg");
+
+	for (int i = 0; i < sizeof(slips) / sizeof(slips[0]); i++)
+	{
+		float gMax, gHdg, eMax, eHdg;
+		const float gFinal = runDrive(slips[i], true, &gMax, &gHdg);
+		const float eFinal = runDrive(slips[i], false, &eMax, &eHdg);
+
+		printf("%5.0f%% %10.2f %10.2f %10.2f %10.2f %10.2f %10.2f\n", slips[i] * 100.0, gFinal, gMax, gHdg, eFinal, eMax, eHdg);
+	}
+
+	//Per-update cost, including the (stubbed) sensor reads and publishing
+	leftTicks = rightTicks = gyroDeg = 0;
+	odom_Init((Encoder)&leftTicks, (Encoder)&rightTicks, (Gyro)&gyroDeg, BENCH_WHEEL_DIAM, BENCH_TRACK);
+
+	const unsigned long long start = host_WallNanos();
+
+	for (int i = 0; i < BENCH_ITERATIONS; i++)
+	{
+		leftTicks += 3;
+		rightTicks += 4;
+		gyroDeg += i & 1;
+		odom_Update();
+	}
+
+	const unsigned long long end = host_WallNanos();
+
+	printf("\nodom_Update: %.1f ns per call on the host\n", (double)(end - start) / BENCH_ITERATIONS);
+
+	return 0;
+}
@@ -0,0 +1,166 @@
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <unistd.h>
+#include "hostAPI.h"
+#include "serialStream.h"
+
+/*
+ * Decodes a serial stream (from a serial port, a pty, or a capture file) into CSV on stdout
+ * Usage: streamDecode [-s mask] <port or file>
+ *   -s mask  Sends a new subscription mask (e.g. 0x7) before reading
+ */
+
+//Sends a subscription frame to the robot
+static void sendSubscription(const int fd, const unsigned int mask)
+{
+	unsigned char raw[7], encoded[STREAM_MAX_ENCODED];
+
+	raw[0] = STREAM_TYPE_SUB;
+	memcpy(&raw[1], &mask, 4);
+	const unsigned short crc = stream_Crc16(raw, 5);
+	raw[5] = crc & 0xFF;
+	raw[6] = crc >> 8;
+
+	unsigned int length = stream_CobsEncode(raw, sizeof(raw), encoded);
+	encoded[length++] = 0;
+
+	if (write(fd, encoded, length) != length)
+	{
+		printf("# could not send subscription\n");
+	}
+}
+
+int main(int argc, char **argv)
+{
+	int arg = 1;
+	long subscribe = -1;
+
+	if (argc > 3 && strcmp(argv[1], "-s") == 0)
+	{
+		subscribe = strtoul(argv[2], NULL, 0);
+		arg = 3;
+	}
+
+	if (arg >= argc)
+	{
+		printf("usage: %s [-s mask] <port or file>\n", argv[0]);
+		return 1;
+	}
+
+	const int fd = open(argv[arg], subscribe >= 0 ? O_RDWR | O_NOCTTY : O_RDONLY | O_NOCTTY);
+
+	if (fd < 0)
+	{
+		printf("could not open %s\n", argv[arg]);
+		return 1;
+	}
+
+	//Raw bytes from a terminal device (the baud rate is left as configured)
+	struct termios tio;
+
+	if (tcgetattr(fd, &tio) == 0)
+	{
+		cfmakeraw(&tio);
+		tcsetattr(fd, TCSANOW, &tio);
+	}
+
+	if (subscribe >= 0)
+	{
+		sendSubscription(fd, subscribe);
+	}
+
+	unsigned char encoded[STREAM_MAX_ENCODED], frame[STREAM_MAX_ENCODED], chunk[256];
+	unsigned int length = 0, lastMask = 0;
+	unsigned long frames = 0, bad = 0, lost = 0;
+	unsigned char expected = 0;
+	ssize_t n;
+
+	while ((n = read(fd, chunk, sizeof(chunk))) > 0)
+	{
+		for (ssize_t i = 0; i < n; i++)
+		{
+			if (chunk[i] != 0)
+			{
+				//Overlong frames are dropped at the next delimiter
+				if (length < sizeof(encoded))
+				{
+					encoded[length] = chunk[i];
+				}
+
+				length++;
+				continue;
+			}
+
+			if (length == 0)
+			{
+				continue;
+			}
+
+			const unsigned int size = length <= sizeof(encoded) ? stream_CobsDecode(encoded, length, frame) : 0;
+			length = 0;
+
+			//Type, sequence, time, mask, CRC
+			if (size < 12 || stream_Crc16(frame, size - 2) != (frame[size - 2] | (frame[size - 1] << 8)) || frame[0] != STREAM_TYPE_DATA)
+			{
+				bad++;
+				continue;
+			}
+
+			unsigned int time, mask;
+			memcpy(&time, &frame[2], 4);
+			memcpy(&mask, &frame[6], 4);
+
+			if (size != 12 + 4 * __builtin_popcount(mask))
+			{
+				bad++;
+				continue;
+			}
+
+			//Sequence gaps are frames lost on the link
+			if (frames > 0)
+			{
+				lost += (unsigned char)(frame[1] - expected);
+			}
+
+			expected = frame[1] + 1;
+			frames++;
+
+			//New header whenever the subscription changes
+			if (mask != lastMask)
+			{
+				printf("time");
+
+				for (int ch = 0; ch < STREAM_CHANNELS; ch++)
+				{
+					if (mask & (1U << ch))
+					{
+						printf(",ch%d", ch);
+					}
+				}
+
+				printf("\n");
+				lastMask = mask;
+			}
+
+			printf("%u", time);
+
+			for (unsigned int offset = 10; offset < size - 2; offset += 4)
+			{
+				float value;
+				memcpy(&value, &frame[offset], 4);
+				printf(",%g", value);
+			}
+
+			//Live output when piped
+			printf("\n");
+			fflush(NULL);
+		}
+	}
+
+	printf("# %lu frames, %lu bad, %lu lost\n", frames, bad, lost);
+
+	close(fd);
+	return 0;
+}
@@ -0,0 +1,69 @@
+#define _GNU_SOURCE
+#include <fcntl.h>
+#include <stdlib.h>
+#include <termios.h>
+#include <unistd.h>
+#include "hostAPI.h"
+#include "math.h"
+#include "serialStream.h"
+
+/*
+ * Local stand-in for a robot streaming over uart2
+ * Opens a pseudo-terminal, prints its name, and streams a simulated flywheel in real time
+ * Channel 0 is the target, 1 the velocity, 2 the error, and 3 the output
+ * Usage: streamPty [seconds]   (then run streamDecode on the printed device)
+ */
+
+int main(int argc, char **argv)
+{
+	const int seconds = argc > 1 ? atoi(argv[1]) : 10;
+
+	const int master = posix_openpt(O_RDWR | O_NOCTTY);
+
+	if (master < 0 || grantpt(master) != 0 || unlockpt(master) != 0)
+	{
+		printf("could not open a pty\n");
+		return 1;
+	}
+
+	//Behave like a serial line: no echo or line editing on the far end
+	const int slave = open(ptsname(master), O_RDWR | O_NOCTTY);
+	struct termios tio;
+
+	if (slave >= 0 && tcgetattr(slave, &tio) == 0)
+	{
+		cfmakeraw(&tio);
+		tcsetattr(slave, TCSANOW, &tio);
+	}
+
+	printf("%s\n", ptsname(master));
+	fflush(NULL);
+
+	host_SetSerialFd(uart2, master);
+	stream_Start(STREAM_DEFAULT_BAUD, 0xF);
+
+	//First order flywheel spinning up to a step target, with measurement noise
+	const float target = 2500;
+	float velocity = 0, output = 0;
+
+	for (unsigned long ms = 0; ms < seconds * 1000UL; ms++)
+	{
+		const float error = target - velocity;
+		output = error * 0.05f;
+		output = output > 127 ? 127 : (output < -127 ? -127 : output);
+		velocity += (output * 25 - velocity) * 0.004f;
+
+		stream_Set(0, target);
+		stream_Set(1, velocity + host_RandomGaussian() * 5);
+		stream_Set(2, error);
+		stream_Set(3, output);
+
+		host_RunTasks();
+		host_AdvanceMicros(1000);
+		usleep(1000);
+	}
+
+	close(slave);
+	close(master);
+	return 0;
+}
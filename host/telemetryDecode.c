@@ -0,0 +1,71 @@
+#include "hostAPI.h"
+#include "telemetry.h"
+
+/*
+ * Decodes a telemetry log file into CSV on stdout
+ * Usage: telemetryDecode <log file>
+ */
+
+int main(int argc, char **argv)
+{
+	if (argc < 2)
+	{
+		printf("usage: %s <log file>\n", argv[0]);
+		return 1;
+	}
+
+	FILE *f = fopen(argv[1], "rb");
+
+	if (f == NULL)
+	{
+		printf("could not open %s\n", argv[1]);
+		return 1;
+	}
+
+	telemetryHeader header;
+
+	if (fread(&header, sizeof(header), 1, f) != 1 || header.magic != TELEMETRY_MAGIC)
+	{
+		printf("%s is not a telemetry log\n", argv[1]);
+		return 1;
+	}
+
+	if (header.version != TELEMETRY_VERSION || header.recordSize != sizeof(telemetryRecord))
+	{
+		printf("unsupported log version %d (record size %d)\n", header.version, header.recordSize);
+		return 1;
+	}
+
+	telemetryRecord r;
+	unsigned long records = 0, dropped = 0, lost = 0;
+	unsigned short expected = 0;
+
+	printf("time,channel,sequence,value\n");
+
+	while (fread(&r, sizeof(r), 1, f) == 1)
+	{
+		//Buffer overflow count from the robot
+		if (r.channel == TELEMETRY_CH_DROPPED)
+		{
+			dropped = r.value;
+			continue;
+		}
+
+		//Sequence gaps are records lost between the buffer and the file
+		if (records > 0 && r.sequence != expected)
+		{
+			lost += (unsigned short)(r.sequence - expected);
+		}
+
+		expected = r.sequence + 1;
+		records++;
+
+		printf("%u,%u,%u,%g\n", r.time, r.channel, r.sequence, r.value);
+	}
+
+	fclose(f);
+
+	printf("# %lu records, %lu dropped (buffer full), %lu lost (write errors)\n", records, dropped, lost);
+
+	return 0;
+}
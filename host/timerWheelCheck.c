@@ -0,0 +1,164 @@
+#include "hostAPI.h"
+#include "timerWheel.h"
+
+/*
+ * Checks the timer wheel against a simulated clock, advancing it every millisecond
+ * Every callback must run in exactly the millisecond it is due, through every level's cascade
+ * Exits nonzero if any check fails
+ */
+
+#define CHECK_TIMERS      500
+#define CHECK_SHORT       400      //Timers below this index are due within CHECK_SHORT_SPAN
+#define CHECK_SHORT_SPAN  100000   //Within the first two levels (ms)
+#define CHECK_LONG_SPAN   20000000 //Reaches the outer levels (ms)
+#define CHECK_CANCELLED   7        //Every 7th of the first 50 timers is cancelled before it fires
+#define CHECK_DURATION    21000000 //Simulated run (ms), past every long one-shot
+#define CHECK_PARKED      100000000UL //Beyond the wheel's range, so the timer is parked and re-cascaded
+
+//Timers and what they should do
+static wheelTimer checkTimers[CHECK_TIMERS];
+static unsigned long checkDue[CHECK_TIMERS];
+static int checkFired[CHECK_TIMERS];
+static int checkLate = 0;
+
+//Failed checks
+static int checkFailures = 0;
+
+/**
+ * Records a firing and when the timer is due next
+ */
+static void checkCallback(void *arg)
+{
+	const int i = (int)(long)arg;
+
+	if (millis() != checkDue[i])
+	{
+		checkLate++;
+	}
+
+	checkFired[i]++;
+	checkDue[i] += checkTimers[i].period;
+}
+
+/**
+ * Advances the simulated clock and the wheel one millisecond at a time
+ *
+ * @param ms Time to run for
+ */
+static void checkRun(const unsigned long ms)
+{
+	for (unsigned long i = 0; i < ms; i++)
+	{
+		host_AdvanceMicros(1000);
+		timerWheel_Advance();
+	}
+}
+
+/**
+ * Records and prints the outcome of one check
+ *
+ * @param name What was checked
+ * @param got Value seen
+ * @param want Expected value
+ */
+static void checkEqual(const char *name, const unsigned long got, const unsigned long want)
+{
+	const bool ok = got == want;
+	checkFailures += !ok;
+
+	printf("%-32s %12lu %12lu%s\n", name, got, want, ok ? "" : "  FAILED");
+}
+
+/**
+ * Gets whether a timer was cancelled by the check
+ */
+static bool checkIsCancelled(const int i)
+{
+	return i < 50 && i % CHECK_CANCELLED == 0;
+}
+
+int main()
+{
+	printf("check                                     got     expected\n");
+
+	//Start away from zero so slot boundaries do not line up with the first timers
+	host_SetMicros(123456789ULL);
+	host_SeedRandom(3);
+	timerWheel_Init();
+
+	//Mixed one-shot and periodic timers spread over every level
+	for (int i = 0; i < CHECK_TIMERS; i++)
+	{
+		const unsigned long delay = host_RandomUniform() * (i < CHECK_SHORT ? CHECK_SHORT_SPAN : CHECK_LONG_SPAN);
+		const unsigned long period = i % 3 == 0 ? 1 + (unsigned long)(host_RandomUniform() * 5000) : 0;
+
+		timerWheel_InitTimer(&(checkTimers[i]));
+		checkDue[i] = millis() + delay;
+		timerWheel_Add(&(checkTimers[i]), delay, period, checkCallback, (void *)(long)i);
+	}
+
+	for (int i = 0; i < 50; i += CHECK_CANCELLED)
+	{
+		timerWheel_Cancel(&(checkTimers[i]));
+	}
+
+	checkRun(CHECK_DURATION);
+
+	int missing = 0, cancelledFired = 0, oneShotRepeated = 0;
+
+	for (int i = 0; i < CHECK_TIMERS; i++)
+	{
+		if (checkIsCancelled(i))
+		{
+			cancelledFired += checkFired[i] > 0;
+		}
+		else
+		{
+			missing += checkFired[i] == 0;
+			oneShotRepeated += checkTimers[i].period == 0 && checkFired[i] > 1;
+		}
+	}
+
+	checkEqual("wheel: callbacks off their ms", checkLate, 0);
+	checkEqual("wheel: timers never fired", missing, 0);
+	checkEqual("wheel: cancelled timers fired", cancelledFired, 0);
+	checkEqual("wheel: one-shots fired twice", oneShotRepeated, 0);
+
+	//Restarting an active timer moves it instead of adding it twice
+	for (int i = 0; i < CHECK_TIMERS; i++)
+	{
+		timerWheel_Cancel(&(checkTimers[i]));
+	}
+
+	checkFired[0] = 0;
+	checkDue[0] = millis() + 700;
+	timerWheel_Add(&(checkTimers[0]), 300, 0, checkCallback, (void *)0);
+	timerWheel_Add(&(checkTimers[0]), 700, 0, checkCallback, (void *)0);
+	checkRun(1000);
+
+	checkEqual("restart: fired", checkFired[0], 1);
+	checkEqual("restart: callbacks off their ms", checkLate, 0);
+
+	//A delay beyond the outermost level waits there and fires on time
+	checkFired[1] = 0;
+	checkDue[1] = millis() + CHECK_PARKED;
+	timerWheel_Add(&(checkTimers[1]), CHECK_PARKED, 0, checkCallback, (void *)1);
+	checkRun(CHECK_PARKED - 1);
+
+	checkEqual("parked: fired early", checkFired[1], 0);
+	checkEqual("parked: active before due", timerWheel_IsActive(&(checkTimers[1])), 1);
+
+	checkRun(1);
+
+	checkEqual("parked: fired", checkFired[1], 1);
+	checkEqual("parked: callbacks off their ms", checkLate, 0);
+	checkEqual("parked: active after firing", timerWheel_IsActive(&(checkTimers[1])), 0);
+
+	if (checkFailures > 0)
+	{
+		printf("%d check(s) failed\n", checkFailures);
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,188 @@
+#include <pthread.h>
+#include <unistd.h>
+#include "workPool.h"
+
+//Jobs left to one worker: [next, end)
+typedef struct poolRange_t
+{
+	pthread_mutex_t lock;
+	int next;
+	int end;
+} poolRange;
+
+typedef struct pool_t
+{
+	poolRange ranges[POOL_MAX_THREADS];
+	int threads;
+	int steals;
+	pthread_mutex_t stealLock;
+
+	void (*fn)(void *, int, int);
+	void *context;
+} pool;
+
+typedef struct poolWorker_t
+{
+	pool *p;
+	int index;
+} poolWorker;
+
+/**
+ * Gets the number of online processors
+ */
+int pool_DefaultThreads()
+{
+	const long n = sysconf(_SC_NPROCESSORS_ONLN);
+	return n < 1 ? 1 : (n > POOL_MAX_THREADS ? POOL_MAX_THREADS : n);
+}
+
+/**
+ * Takes the next job from a worker's own range (front), or returns -1 if it is empty
+ */
+static int poolTake(poolRange *r)
+{
+	int job = -1;
+
+	pthread_mutex_lock(&(r->lock));
+
+	if (r->next < r->end)
+	{
+		job = r->next++;
+	}
+
+	pthread_mutex_unlock(&(r->lock));
+
+	return job;
+}
+
+/**
+ * Moves the back half of the largest other range into a worker's range
+ * Returns whether anything was left to steal
+ */
+static int poolSteal(pool *p, const int thief)
+{
+	//Steals are rare, so one lock for choosing a victim keeps this simple
+	pthread_mutex_lock(&(p->stealLock));
+
+	int victim = -1, most = 0;
+
+	for (int i = 0; i < p->threads; i++)
+	{
+		const int left = p->ranges[i].end - p->ranges[i].next;
+
+		if (i != thief && left > most)
+		{
+			most = left;
+			victim = i;
+		}
+	}
+
+	int stolen = 0;
+
+	if (victim >= 0)
+	{
+		poolRange *v = &(p->ranges[victim]);
+		pthread_mutex_lock(&(v->lock));
+
+		const int left = v->end - v->next;
+
+		if (left > 0)
+		{
+			//Leave the victim the front half (it is working from the front)
+			const int take = (left + 1) / 2;
+			const int start = v->end - take;
+			v->end = start;
+
+			poolRange *t = &(p->ranges[thief]);
+			pthread_mutex_lock(&(t->lock));
+			t->next = start;
+			t->end = start + take;
+			pthread_mutex_unlock(&(t->lock));
+
+			p->steals++;
+			stolen = 1;
+		}
+
+		pthread_mutex_unlock(&(v->lock));
+	}
+
+	pthread_mutex_unlock(&(p->stealLock));
+
+	return stolen;
+}
+
+static void *poolWorkerMain(void *arg)
+{
+	poolWorker *w = arg;
+	pool *p = w->p;
+
+	while (1)
+	{
+		const int job = poolTake(&(p->ranges[w->index]));
+
+		if (job >= 0)
+		{
+			p->fn(p->context, job, w->index);
+		}
+		else if (!poolSteal(p, w->index))
+		{
+			//Nothing left anywhere (jobs never add jobs)
+			break;
+		}
+	}
+
+	return NULL;
+}
+
+/**
+ * Runs jobs 0 to count - 1 and returns once all are done
+ *
+ * @param threads Worker threads (at most POOL_MAX_THREADS, 0 for one per processor)
+ * @param count Number of jobs
+ * @param fn Called once per job with (context, job, worker)
+ * @param context Passed to every call
+ * @return Number of ranges stolen (for reporting load balance)
+ */
+int pool_Run(int threads, const int count, void (*fn)(void *, int, int), void *context)
+{
+	pool p;
+	pthread_t handles[POOL_MAX_THREADS];
+	poolWorker workers[POOL_MAX_THREADS];
+
+	threads = threads <= 0 ? pool_DefaultThreads() : (threads > POOL_MAX_THREADS ? POOL_MAX_THREADS : threads);
+
+	p.threads = threads;
+	p.steals = 0;
+	p.fn = fn;
+	p.context = context;
+	pthread_mutex_init(&(p.stealLock), NULL);
+
+	//Even split up front
+	for (int i = 0; i < threads; i++)
+	{
+		pthread_mutex_init(&(p.ranges[i].lock), NULL);
+		p.ranges[i].next = (long)count * i / threads;
+		p.ranges[i].end = (long)count * (i + 1) / threads;
+	}
+
+	for (int i = 0; i < threads; i++)
+	{
+		workers[i].p = &p;
+		workers[i].index = i;
+		pthread_create(&(handles[i]), NULL, poolWorkerMain, &(workers[i]));
+	}
+
+	for (int i = 0; i < threads; i++)
+	{
+		pthread_join(handles[i], NULL);
+	}
+
+	for (int i = 0; i < threads; i++)
+	{
+		pthread_mutex_destroy(&(p.ranges[i].lock));
+	}
+
+	pthread_mutex_destroy(&(p.stealLock));
+
+	return p.steals;
+}
@@ -0,0 +1,28 @@
+#ifndef WORKPOOL_H_
+#define WORKPOOL_H_
+
+/*
+ * Work-stealing thread pool for independent host jobs (e.g. simulation runs)
+ * Jobs are split into one contiguous range per worker; a worker which runs out steals half of the
+ * largest remaining range, so uneven job costs still keep every core busy
+ */
+
+#define POOL_MAX_THREADS 64
+
+/**
+ * Gets the number of online processors
+ */
+int pool_DefaultThreads();
+
+/**
+ * Runs jobs 0 to count - 1 and returns once all are done
+ *
+ * @param threads Worker threads (at most POOL_MAX_THREADS, 0 for one per processor)
+ * @param count Number of jobs
+ * @param fn Called once per job with (context, job, worker)
+ * @param context Passed to every call
+ * @return Number of ranges stolen (for reporting load balance)
+ */
+int pool_Run(int threads, const int count, void (*fn)(void *, int, int), void *context);
+
+#endif
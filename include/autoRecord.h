@@ -0,0 +1,98 @@
+#ifndef AUTORECORD_H_
+#define AUTORECORD_H_
+
+#include <stdbool.h>
+#include "API.h"
+
+//Autonomous recorder general
+#define AUTO_RECORD_PERIOD     20         //Default sample period in ms
+#define AUTO_RECORD_CHANNELS   16         //Most values per frame (one bit each in a change mask)
+#define AUTO_RECORD_BUFFER     256        //Encoded bytes held before each fwrite
+#define AUTO_RECORD_READ_AHEAD 64         //Encoded bytes read per fread during playback
+#define AUTO_RECORD_MAGIC      0x41494342 //"BCIA" at the start of every recording
+#define AUTO_RECORD_VERSION    1
+
+//Stream tokens
+#define AUTO_RECORD_TOKEN_DELTA 0x00 //Change mask (2 bytes) then a zigzag varint delta per changed channel
+#define AUTO_RECORD_TOKEN_END   0x01 //End of the recording
+#define AUTO_RECORD_TOKEN_RUN   0x80 //Low 7 bits + 1 frames identical to the previous one
+#define AUTO_RECORD_MAX_RUN     128
+
+//What is recorded
+typedef enum
+{
+	AUTO_RECORD_MOTORS = 0,  //reqSpeed of every motor, then of every motor group
+	AUTO_RECORD_JOYSTICK = 1 //Shaped joystick axes, then held buttons, from the joystick snapshot
+} autoRecordSource;
+
+//Recording file header
+typedef struct autoRecordHeader_t
+{
+	unsigned int magic;
+	unsigned short version;
+	unsigned char source;
+	unsigned char channels;
+	unsigned short period; //Sample period in ms
+	unsigned short reserved;
+} autoRecordHeader;
+
+/**
+ * Opens a recording file and starts sampling into it
+ *
+ * @param file File name on the PROS file system
+ * @param source What to record
+ * @param period Sample period in ms (e.g. AUTO_RECORD_PERIOD)
+ * @return Whether the file was opened and its header written
+ */
+bool autoRecord_StartRecording(const char *file, const autoRecordSource source, const unsigned short period);
+
+/**
+ * Stops sampling, ends the recording, and closes its file (the file is only kept once closed)
+ *
+ * @return Whether the whole recording was written (false if, for example, the file system filled up)
+ */
+bool autoRecord_StopRecording();
+
+/**
+ * Samples and encodes one frame
+ * Called by the recording task; only call directly if the task is not running
+ */
+void autoRecord_Record();
+
+/**
+ * Opens a recording and starts playing it back at the period it was recorded at
+ *
+ * @param file File name on the PROS file system
+ * @return Whether the file was opened and is a valid recording
+ */
+bool autoRecord_StartPlayback(const char *file);
+
+/**
+ * Stops playback, zeroing recorded motors (or releasing the joystick snapshot), and closes the file
+ */
+void autoRecord_StopPlayback();
+
+/**
+ * Decodes and applies one frame
+ * Called by the playback task; only call directly if the task is not running
+ *
+ * @return Whether a frame was applied (false once the recording has ended)
+ */
+bool autoRecord_Play();
+
+/**
+ * Gets whether a recording is being played back
+ */
+inline bool autoRecord_IsPlaying();
+
+/**
+ * Gets the number of frames recorded or played back so far
+ */
+inline unsigned int autoRecord_GetFrames();
+
+/**
+ * Gets the number of encoded bytes written or read so far (excluding the header)
+ */
+inline unsigned int autoRecord_GetBytes();
+
+#endif
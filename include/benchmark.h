@@ -0,0 +1,95 @@
+#ifndef BENCHMARK_H_
+#define BENCHMARK_H_
+
+#include <stdbool.h>
+#include "API.h"
+
+/*
+ * Microbenchmarks of the library's hot paths
+ * Ticks are CPU cycles on the Cortex (DWT cycle counter) and nanoseconds on a host
+ */
+
+//Benchmark general
+#define BENCH_CASES     12   //filter_DEMA, filter_TUA, vel_TBH_StepController, pos_PID_StepController,
+                             //filter_Median and filter_Hampel over windows of 3, 7, 11, and 15
+#define BENCH_SAMPLES   101  //Timed samples per case (odd, so the median is a sample)
+#define BENCH_BATCH     64   //Calls per sample
+#define BENCH_TOLERANCE 0.05 //Default allowed slowdown of a median (cycle counts barely vary on the Cortex)
+
+//Baseline file: a header, then one entry per case, matched to results by name
+#define BENCH_BASELINE_MAGIC   0x4C534242 //"BBSL"
+#define BENCH_BASELINE_VERSION 1
+#define BENCH_NAME_LENGTH      16         //Longest case name, including the terminator
+
+//Cost of one benchmarked function, in ticks per call
+typedef struct benchResult_t
+{
+	const char *name;
+	float min;
+	float median;
+	float p90;
+	float p99;
+
+	//Baseline median (0 if there is none)
+	float baseline;
+	bool regressed;
+	bool unmatched; //The baseline has no case with this name
+} benchResult;
+
+//Header of a baseline file
+typedef struct benchBaselineHeader_t
+{
+	unsigned int magic;
+	unsigned short version;
+	unsigned short count; //Entries that follow
+} benchBaselineHeader;
+
+//Baseline of one case
+typedef struct benchBaselineEntry_t
+{
+	char name[BENCH_NAME_LENGTH];
+	float median;
+} benchBaselineEntry;
+
+/**
+ * Enables the cycle counter (call once before benchmarking on the Cortex)
+ */
+void bench_Init();
+
+/**
+ * Gets the current tick count (cycles on the Cortex, ns on a host)
+ */
+unsigned int bench_Now();
+
+/**
+ * Times every case
+ *
+ * @param results Array of at least BENCH_CASES results to fill
+ * @return Number of cases run
+ */
+int bench_RunSuite(benchResult *results);
+
+/**
+ * Checks results against a baseline file, writing the file if it does not exist
+ * Cases are matched by name; an existing baseline is only replaced when update is set
+ *
+ * @param results Results from bench_RunSuite
+ * @param count Number of results
+ * @param file Baseline file name
+ * @param update Overwrite the baseline with these results
+ * @param tolerance Allowed slowdown of a median (e.g. BENCH_TOLERANCE)
+ * @return Number of regressed cases, plus cases missing from the baseline and baseline cases no
+ * longer run (the regression gate fails if nonzero), or -1 if the baseline cannot be read
+ */
+int bench_Compare(benchResult *results, const int count, const char *file, const bool update, const float tolerance);
+
+/**
+ * Prints a table of results
+ *
+ * @param port Where to print (stdout, uart1, or uart2)
+ * @param results Results from bench_RunSuite
+ * @param count Number of results
+ */
+void bench_Print(FILE *port, const benchResult *results, const int count);
+
+#endif
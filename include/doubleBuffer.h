@@ -0,0 +1,59 @@
+#ifndef DOUBLEBUFFER_H_
+#define DOUBLEBUFFER_H_
+
+//Sets up a double buffer over an array of two buffers, e.g. static doubleBuffer db = DOUBLE_BUFFER(buffers);
+#define DOUBLE_BUFFER(buffers) { (buffers), sizeof((buffers)[0]), 0 }
+
+//Two buffers published by one writer task; the writer fills the back one and flips, readers copy the front one
+typedef struct doubleBuffer_t
+{
+	void *buffers;               //Two buffers of size bytes each, back to back
+	unsigned int size;           //Size of one buffer in bytes
+	volatile unsigned int flips; //Low bit picks the front buffer
+} doubleBuffer;
+
+/**
+ * Gets the buffer readers are copying
+ * Only the writer may call this, and must not modify the buffer
+ *
+ * @param db The double buffer
+ */
+const void* doubleBuffer_GetFront(doubleBuffer *db);
+
+/**
+ * Gets the buffer to fill before the next flip
+ * Only the writer may call this
+ *
+ * @param db The double buffer
+ */
+void* doubleBuffer_GetBack(doubleBuffer *db);
+
+/**
+ * Makes the back buffer the front one
+ * Only the writer may call this, once the back buffer is complete
+ *
+ * @param db The double buffer
+ */
+void doubleBuffer_Flip(doubleBuffer *db);
+
+/**
+ * Copies a whole buffer into the back buffer and flips it to the front
+ * Only the writer may call this
+ *
+ * @param db The double buffer
+ * @param src Data to publish (one buffer's worth)
+ */
+void doubleBuffer_Write(doubleBuffer *db, const void *src);
+
+/**
+ * Copies part of the front buffer
+ * Lock-free and safe to call from any task
+ *
+ * @param db The double buffer
+ * @param out Destination
+ * @param offset Byte offset into the buffer
+ * @param size Bytes to copy
+ */
+void doubleBuffer_Read(doubleBuffer *db, void *out, const unsigned int offset, const unsigned int size);
+
+#endif
@@ -0,0 +1,92 @@
+#ifndef DRIVEKINEMATICS_H_
+#define DRIVEKINEMATICS_H_
+
+//Drive kinematics general
+#define DRIVE_WHEELS_MAX 4 //Motor groups driven by one drive
+
+//Drivetrain layouts
+typedef enum
+{
+	DRIVE_LAYOUT_TANK = 0,     //Left and right groups (tank and arcade mixing)
+	DRIVE_LAYOUT_HOLONOMIC = 1 //Front left, front right, back left, and back right groups (X-drive or mecanum)
+} driveLayout;
+
+//Drive mixer
+typedef struct driveKinematics_t
+{
+	driveLayout layout;
+	unsigned char groups[DRIVE_WHEELS_MAX]; //Motor groups in layout order
+	unsigned char count;
+
+	//Output of the last mix, in layout order
+	int outputs[DRIVE_WHEELS_MAX];
+} driveKinematics;
+
+/**
+ * Initializes a drive with a left and a right side
+ *
+ * @param dk The drive
+ * @param leftGroup Left side motor group
+ * @param rightGroup Right side motor group
+ */
+void driveKinematics_InitTank(driveKinematics *dk, const unsigned char leftGroup, const unsigned char rightGroup);
+
+/**
+ * Initializes an X-drive or mecanum drive
+ * Wheels are mixed the same way; each group's scale should make positive power drive its wheel forward
+ *
+ * @param dk The drive
+ * @param frontLeft Front left motor group
+ * @param frontRight Front right motor group
+ * @param backLeft Back left motor group
+ * @param backRight Back right motor group
+ */
+void driveKinematics_InitHolonomic(driveKinematics *dk, const unsigned char frontLeft, const unsigned char frontRight, const unsigned char backLeft, const unsigned char backRight);
+
+/**
+ * Drives each side directly
+ *
+ * @param dk The drive
+ * @param left Left side power
+ * @param right Right side power
+ */
+void driveKinematics_Tank(driveKinematics *dk, const int left, const int right);
+
+/**
+ * Drives from a forward and a turn command
+ * On a holonomic drive this is the same as driveKinematics_Holonomic with no strafe
+ *
+ * @param dk The drive
+ * @param forward Forward power
+ * @param turn Turn power (positive turns clockwise)
+ */
+void driveKinematics_Arcade(driveKinematics *dk, const int forward, const int turn);
+
+/**
+ * Drives a holonomic drive from forward, strafe, and turn commands
+ * On a tank drive, strafe is ignored
+ *
+ * @param dk The drive
+ * @param forward Forward power
+ * @param strafe Strafe power (positive strafes right)
+ * @param turn Turn power (positive turns clockwise)
+ */
+void driveKinematics_Holonomic(driveKinematics *dk, const int forward, const int strafe, const int turn);
+
+/**
+ * Scales wheel powers down together so none exceeds MOTOR_MAX_VALUE, keeping their ratios
+ *
+ * @param powers Wheel powers
+ * @param count Number of wheels
+ */
+void driveKinematics_Desaturate(int *powers, const unsigned char count);
+
+/**
+ * Gets the output of one wheel from the last mix
+ *
+ * @param dk The drive
+ * @param wheel Wheel in layout order
+ */
+inline int driveKinematics_GetOutput(driveKinematics *dk, const unsigned char wheel);
+
+#endif
@@ -0,0 +1,106 @@
+#ifndef DRIVESYNC_H_
+#define DRIVESYNC_H_
+
+#include "API.h"
+#include "positionPID.h"
+
+//What the sync term corrects
+typedef enum
+{
+	DRIVE_SYNC_ENCODER = 0, //Difference in left and right encoder travel (kSync is power per tick)
+	DRIVE_SYNC_GYRO = 1     //Change in gyro heading (kSync is power per gyro unit)
+} driveSyncSource;
+
+//Synchronized left/right drive controller
+typedef struct driveSync_t
+{
+	//Distance controller, stepped on the average of both sides
+	pos_PID distance;
+
+	//Cross-coupling
+	float kSync;
+	driveSyncSource source;
+	Gyro gyro;
+
+	//Readings when the target was set
+	int leftStart;
+	int rightStart;
+	int headingStart;
+
+	//Motor groups
+	unsigned char leftGroup;
+	unsigned char rightGroup;
+
+	//Calculations
+	int syncError;
+
+	//Output
+	int leftOut;
+	int rightOut;
+} driveSync;
+
+/**
+ * Initializes a synchronized drive controller
+ *
+ * @param ds The drive controller
+ * @param kP Distance proportional gain
+ * @param kI Distance integral gain
+ * @param kD Distance derivative gain
+ * @param kSync Cross-coupling gain
+ * @param leftGroup Left side motor group
+ * @param rightGroup Right side motor group
+ */
+void driveSync_InitController(driveSync *ds, const float kP, const float kI, const float kD, const float kSync, const unsigned char leftGroup, const unsigned char rightGroup);
+
+/**
+ * Sets the motor groups driven by the controller
+ *
+ * @param ds The drive controller
+ * @param leftGroup Left side motor group
+ * @param rightGroup Right side motor group
+ */
+inline void driveSync_SetMotorGroups(driveSync *ds, const unsigned char leftGroup, const unsigned char rightGroup);
+
+/**
+ * Synchronizes on gyro heading instead of encoder difference
+ *
+ * @param ds The drive controller
+ * @param gyro The gyro, or NULL to go back to encoder difference
+ */
+void driveSync_UseGyro(driveSync *ds, Gyro gyro);
+
+/**
+ * Sets a new distance to drive straight from the current position
+ *
+ * @param ds The drive controller
+ * @param target Distance to drive in encoder ticks
+ * @param leftSens Current left encoder reading
+ * @param rightSens Current right encoder reading
+ */
+void driveSync_SetTarget(driveSync *ds, const int target, const int leftSens, const int rightSens);
+
+/**
+ * Gets the current distance error
+ *
+ * @param ds The drive controller
+ */
+inline int driveSync_GetError(driveSync *ds);
+
+/**
+ * Gets the current sync error
+ *
+ * @param ds The drive controller
+ */
+inline int driveSync_GetSyncError(driveSync *ds);
+
+/**
+ * Steps the controller's calculations and sets both motor groups
+ *
+ * @param ds The drive controller
+ * @param leftSens New left encoder reading
+ * @param rightSens New right encoder reading
+ * @return Common (distance) output
+ */
+int driveSync_StepController(driveSync *ds, const int leftSens, const int rightSens);
+
+#endif
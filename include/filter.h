@@ -1,6 +1,12 @@
 #ifndef FILTER_H_
 #define FILTER_H_
 
+#include <stdbool.h>
+
+//Median filter general
+#define FILTER_MEDIAN_MAX 15     //Largest median window
+#define FILTER_HAMPEL_MAD 1.4826 //Scales a median absolute deviation to a standard deviation for Gaussian noise
+
 //Exponential moving average filter
 typedef struct EMAFilter_t
 {
@@ -31,6 +37,34 @@ typedef struct TUAFilter_t
     int index;
 } TUAFilter;
 
+//Running median filter
+typedef struct MedianFilter_t
+{
+    float components[FILTER_MEDIAN_MAX]; //Ring in arrival order
+    float sorted[FILTER_MEDIAN_MAX];     //The same values in ascending order
+    int index;
+    int size;
+    int count;
+} MedianFilter;
+
+//Hampel filter (replaces outliers with the median of the window)
+typedef struct HampelFilter_t
+{
+    MedianFilter median;
+    float threshold; //Outlier limit in standard deviations
+    bool outlier;    //Whether the last input was replaced
+} HampelFilter;
+
+//Rate of change gate (holds its output through single-sample jumps)
+typedef struct RateGateFilter_t
+{
+    float output;
+    float maxStep;  //Largest accepted change per sample
+    int rejectLimit; //Consecutive rejections before a jump is accepted as real
+    int rejected;
+    bool started;
+} RateGateFilter;
+
 /**
  * Initializes an exponential moving average filter
  *
@@ -94,4 +128,54 @@ void filter_Init_TUA(TUAFilter *filter);
  */
 float filter_TUA(TUAFilter *filter, const float componentIn);
 
+/**
+ * Initializes a running median filter
+ *
+ * @param filter The median filter
+ * @param size Window size (odd, 3 to FILTER_MEDIAN_MAX)
+ */
+void filter_Init_Median(MedianFilter *filter, const int size);
+
+/**
+ * Filters an input
+ *
+ * @param filter The median filter
+ * @param componentIn Input to filter
+ */
+float filter_Median(MedianFilter *filter, const float componentIn);
+
+/**
+ * Initializes a Hampel filter
+ *
+ * @param filter The Hampel filter
+ * @param size Window size (odd, 3 to FILTER_MEDIAN_MAX)
+ * @param threshold Outlier limit in standard deviations (3 is typical)
+ */
+void filter_Init_Hampel(HampelFilter *filter, const int size, const float threshold);
+
+/**
+ * Filters an input, passing it through unless it is an outlier
+ *
+ * @param filter The Hampel filter
+ * @param componentIn Input to filter
+ */
+float filter_Hampel(HampelFilter *filter, const float componentIn);
+
+/**
+ * Initializes a rate of change gate
+ *
+ * @param filter The rate gate
+ * @param maxStep Largest accepted change per sample
+ * @param rejectLimit Consecutive rejections before a jump is accepted as real
+ */
+void filter_Init_RateGate(RateGateFilter *filter, const float maxStep, const int rejectLimit);
+
+/**
+ * Filters an input, holding the last output if it changed too quickly
+ *
+ * @param filter The rate gate
+ * @param componentIn Input to filter
+ */
+float filter_RateGate(RateGateFilter *filter, const float componentIn);
+
 #endif
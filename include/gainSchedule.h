@@ -0,0 +1,78 @@
+#ifndef GAINSCHEDULE_H_
+#define GAINSCHEDULE_H_
+
+//Variable a gain schedule is indexed by
+typedef enum
+{
+	GAIN_SCHEDULE_SETPOINT = 0, //Controller target
+	GAIN_SCHEDULE_MEASURED = 1, //Sensor reading (or velocity) passed to the controller
+	GAIN_SCHEDULE_USER = 2      //Value set with gainSchedule_SetUserValue
+} gainScheduleSource;
+
+//One row of a gain table
+typedef struct gainScheduleEntry_t
+{
+	float index; //Value of the lookup variable these gains apply at
+	float kP;
+	float kI;
+	float kD;
+} gainScheduleEntry;
+
+//Gain schedule representation
+typedef struct gainSchedule_t
+{
+	//Table (rows sorted by ascending index, may be const and live in flash)
+	const gainScheduleEntry *table;
+	unsigned char size;
+
+	//Lookup variable
+	gainScheduleSource source;
+	float userValue;
+
+	//Cached segment, checked first on the next lookup
+	unsigned char segment;
+	float segmentInvSpan;
+
+	//Output
+	float kP;
+	float kI;
+	float kD;
+} gainSchedule;
+
+/**
+ * Initializes a gain schedule
+ *
+ * @param gs The gain schedule
+ * @param table Rows of gains sorted by ascending index
+ * @param size Number of rows in `table` (at least one)
+ * @param source Variable the table is indexed by
+ */
+void gainSchedule_Init(gainSchedule *gs, const gainScheduleEntry *table, const unsigned char size, const gainScheduleSource source);
+
+/**
+ * Sets the lookup value used when the source is GAIN_SCHEDULE_USER
+ *
+ * @param gs The gain schedule
+ * @param value New lookup value (e.g. lift load or battery voltage)
+ */
+inline void gainSchedule_SetUserValue(gainSchedule *gs, const float value);
+
+/**
+ * Looks up and interpolates gains for a lookup value
+ * Constant time while the value stays in or next to the last segment, O(log n) otherwise
+ *
+ * @param gs The gain schedule
+ * @param index Lookup value
+ */
+void gainSchedule_Lookup(gainSchedule *gs, const float index);
+
+/**
+ * Looks up gains using the schedule's configured source
+ *
+ * @param gs The gain schedule
+ * @param setpoint Current controller target
+ * @param measured Current sensor reading
+ */
+void gainSchedule_Update(gainSchedule *gs, const float setpoint, const float measured);
+
+#endif
@@ -0,0 +1,119 @@
+#ifndef GYROTRACKER_H_
+#define GYROTRACKER_H_
+
+#include <stdbool.h>
+#include "API.h"
+
+//Gyro tracker general
+#define GYRO_TRACKER_SCALE        1.1   //Default deg/s per ADC count (VEX yaw rate gyro, tune with gyroTracker_SetScale)
+#define GYRO_TRACKER_CALIBRATION  1000  //Samples averaged by gyroTracker_Calibrate (one per ms)
+#define GYRO_TRACKER_SETTLE       250   //Stationary time in ms before bias tracking starts
+#define GYRO_TRACKER_ALPHA        0.002 //Bias tracking filter constant per step while stationary
+#define GYRO_TRACKER_STILL_SPEED  5     //Encoder speed in ticks/s under which a side counts as stopped
+
+//Gyro integrated from its raw analog channel with a tracked bias
+typedef struct gyroTracker_t
+{
+	//Sensor
+	unsigned char channel; //Analog channel of the gyro
+	float scale;           //deg/s per ADC count (negative to flip direction)
+
+	//Bias in ADC counts, and the noise measured during calibration
+	float bias;
+	float noise;
+
+	//Encoders used to detect a stationary robot (NULL if not used)
+	Encoder left;
+	Encoder right;
+	int prevLeft;
+	int prevRight;
+
+	//Stationary detection
+	unsigned long stillSince; //micros() when the robot was last seen moving
+	bool stationary;          //True while the bias is being tracked
+
+	//Output
+	float rate;    //deg/s
+	float heading; //deg, counterclockwise positive
+	unsigned long prevTime;
+} gyroTracker;
+
+/**
+ * Initializes a gyro tracker (call gyroTracker_Calibrate before use)
+ *
+ * @param gt The gyro tracker
+ * @param channel Analog channel of the gyro
+ */
+void gyroTracker_Init(gyroTracker *gt, const unsigned char channel);
+
+/**
+ * Sets the gyro's scale
+ *
+ * @param gt The gyro tracker
+ * @param scale deg/s per ADC count (negative to flip direction)
+ */
+inline void gyroTracker_SetScale(gyroTracker *gt, const float scale);
+
+/**
+ * Sets the encoders used to detect a stationary robot, enabling bias tracking
+ *
+ * @param gt The gyro tracker
+ * @param left Left side quad encoder, or NULL to disable bias tracking
+ * @param right Right side quad encoder
+ */
+void gyroTracker_SetEncoders(gyroTracker *gt, Encoder left, Encoder right);
+
+/**
+ * Averages the gyro while the robot is still to find its bias
+ * Blocks for GYRO_TRACKER_CALIBRATION ms; the robot must not move
+ *
+ * @param gt The gyro tracker
+ */
+void gyroTracker_Calibrate(gyroTracker *gt);
+
+/**
+ * Reads the gyro and integrates heading
+ * Cheap enough to call from the sensor sampling loop; call at a steady, fast rate (e.g. every 1 to 5ms)
+ *
+ * @param gt The gyro tracker
+ * @return Heading in degrees
+ */
+float gyroTracker_Step(gyroTracker *gt);
+
+/**
+ * Sets the current heading
+ *
+ * @param gt The gyro tracker
+ * @param heading New heading in degrees
+ */
+inline void gyroTracker_SetHeading(gyroTracker *gt, const float heading);
+
+/**
+ * Gets the heading in degrees
+ *
+ * @param gt The gyro tracker
+ */
+inline float gyroTracker_GetHeading(gyroTracker *gt);
+
+/**
+ * Gets the rate of turn in deg/s
+ *
+ * @param gt The gyro tracker
+ */
+inline float gyroTracker_GetRate(gyroTracker *gt);
+
+/**
+ * Gets the current bias in ADC counts
+ *
+ * @param gt The gyro tracker
+ */
+inline float gyroTracker_GetBias(gyroTracker *gt);
+
+/**
+ * Gets whether the robot is stationary and the bias is being tracked
+ *
+ * @param gt The gyro tracker
+ */
+inline bool gyroTracker_IsStationary(gyroTracker *gt);
+
+#endif
@@ -0,0 +1,115 @@
+#ifndef IMEMANAGER_H_
+#define IMEMANAGER_H_
+
+#include <stdbool.h>
+#include "API.h"
+
+//IME manager general
+#define IME_MANAGER_MAX        10   //IMEs managed (more than 10 on one chain is unreliable)
+#define IME_MANAGER_PERIOD     5    //Run a batch every 5ms
+#define IME_MANAGER_BUDGET     2000 //Bus time per batch in us before non-critical IMEs are slowed down
+#define IME_MANAGER_DIVIDER    4    //Default: poll every fourth batch
+#define IME_MANAGER_MAX_DIVIDER 64  //Slowest rate for adapted or failing IMEs
+#define IME_MANAGER_ERROR_LIMIT 5   //Consecutive failures before an IME is backed off
+
+//Cached state and statistics of one IME
+typedef struct imeDevice_t
+{
+	//Polling
+	unsigned char divider;    //Configured rate: poll every divider batches (1 is critical, never slowed)
+	unsigned char adapted;    //Current rate after adapting to bus load and errors
+	unsigned char countdown;
+	bool readVelocity;        //Also read the IME's own velocity (a second bus transaction)
+
+	//Cache (written only by the IME manager task; readers use imeManager_Get)
+	int count;
+	float velocity;           //Counts per second (or imeGetVelocity's RPM if readVelocity is set)
+	unsigned long time;       //micros() of the last good read
+
+	//Statistics
+	unsigned int reads;
+	unsigned int errors;
+	unsigned int consecutiveErrors;
+	unsigned int latencyLast; //us
+	unsigned int latencyMax;  //us
+	unsigned long long latencyTotal;
+} imeDevice;
+
+//A cached IME reading
+typedef struct imeReading_t
+{
+	int count;
+	float velocity;
+	unsigned long age; //us since the values were read
+	bool valid;        //False if the IME has never been read
+} imeReading;
+
+/**
+ * Initializes every IME on the chain and manages all of them
+ *
+ * @return Number of IMEs found
+ */
+unsigned int imeManager_Init();
+
+/**
+ * Sets how often an IME is polled
+ *
+ * @param address IME address
+ * @param divider Poll every divider batches (1 for critical IMEs such as a flywheel, which are never slowed down)
+ * @param readVelocity Also read the IME's own velocity instead of differentiating counts
+ */
+void imeManager_SetRate(const unsigned char address, const unsigned char divider, const bool readVelocity);
+
+/**
+ * Polls every IME which is due in one batch
+ * Called by the IME manager task; only call directly if the task is not running
+ */
+void imeManager_Poll();
+
+/**
+ * Gets the cached state of an IME
+ *
+ * @param address IME address
+ * @param out Reading to fill
+ */
+void imeManager_Get(const unsigned char address, imeReading *out);
+
+/**
+ * Gets the cached count of an IME
+ *
+ * @param address IME address
+ */
+int imeManager_GetCount(const unsigned char address);
+
+/**
+ * Gets the cached velocity of an IME
+ *
+ * @param address IME address
+ */
+float imeManager_GetVelocity(const unsigned char address);
+
+/**
+ * Gets an IME's state and statistics
+ *
+ * @param address IME address
+ */
+inline const imeDevice* imeManager_GetDevice(const unsigned char address);
+
+/**
+ * Gets the number of managed IMEs
+ */
+inline unsigned int imeManager_GetDeviceCount();
+
+/**
+ * Prints read latency and error counters of every IME
+ *
+ * @param port Where to print (stdout, uart1, or uart2)
+ */
+void imeManager_Print(FILE *port);
+
+/*
+ * Starts the IME manager task
+ */
+void startIMEManagerTask();
+
+#endif
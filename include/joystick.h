@@ -0,0 +1,148 @@
+#ifndef JOYSTICK_H_
+#define JOYSTICK_H_
+
+#include <stdbool.h>
+
+//Joystick general
+#define JOYSTICK_NUM       2   //Main and partner joysticks
+#define JOYSTICK_AXES      4   //Analog axes per joystick (1 to 4)
+#define JOYSTICK_DEADBAND  10  //Default deadband in joystick counts
+#define JOYSTICK_MAX_VALUE 127 //Full deflection
+
+//Button bit of group 5 to 8 and JOY_DOWN, JOY_LEFT, JOY_UP, or JOY_RIGHT in a snapshot's buttons
+#define joystickButtonBit(group, button) ( (unsigned short)(button) << (((group) - 5) * 4) )
+
+//Response curves
+typedef enum
+{
+	JOYSTICK_CURVE_LINEAR = 0, //Output follows the stick
+	JOYSTICK_CURVE_EXPO = 1,   //Blend of linear and cubic set by expo (0 is linear, 1 is cubic)
+	JOYSTICK_CURVE_CUBIC = 2   //Output is the cube of the stick, as cube(x) / CUBED_127
+} joystickCurve;
+
+//Shaping of one axis
+typedef struct joystickAxis_t
+{
+	signed char table[256]; //Shaped output indexed by reading + 128 (calibration, deadband, and curve baked in)
+	int slew;               //Largest output change per sample (0 for none)
+	int output;             //Last shaped output, after slewing
+
+	//Settings the table was built from
+	joystickCurve curve;
+	float expo;
+	int deadband;
+	int center;
+	int min;
+	int max;
+} joystickAxis;
+
+//Both joysticks sampled at one time
+typedef struct joystickSnapshot_t
+{
+	int axes[JOYSTICK_NUM][JOYSTICK_AXES]; //Shaped outputs, indexed by axis - 1
+	unsigned short buttons[JOYSTICK_NUM];  //Held buttons (see joystickButtonBit)
+	unsigned short pressed[JOYSTICK_NUM];  //Buttons which went down this sample
+	unsigned long time;                    //millis() of the sample
+} joystickSnapshot;
+
+/**
+ * Initializes every axis to a linear curve with JOYSTICK_DEADBAND and no slew
+ */
+void joystick_Init();
+
+/**
+ * Sets the response curve of an axis and rebuilds its table
+ *
+ * @param joystick Joystick (1 or 2)
+ * @param axis Axis (1 to 4)
+ * @param curve Response curve
+ * @param expo Cubic fraction for JOYSTICK_CURVE_EXPO (0 to 1)
+ * @param deadband Readings within this many counts of center give 0
+ */
+void joystick_SetCurve(const unsigned char joystick, const unsigned char axis, const joystickCurve curve, const float expo, const int deadband);
+
+/**
+ * Sets the calibration of an axis and rebuilds its table
+ *
+ * @param joystick Joystick (1 or 2)
+ * @param axis Axis (1 to 4)
+ * @param center Reading at rest
+ * @param min Reading at full negative deflection
+ * @param max Reading at full positive deflection
+ */
+void joystick_SetCalibration(const unsigned char joystick, const unsigned char axis, const int center, const int min, const int max);
+
+/**
+ * Takes the current reading of every axis as its center (the sticks must be at rest)
+ */
+void joystick_CalibrateCenters();
+
+/**
+ * Sets the slew rate of an axis
+ *
+ * @param joystick Joystick (1 or 2)
+ * @param axis Axis (1 to 4)
+ * @param slew Largest output change per sample (0 for none)
+ */
+void joystick_SetSlew(const unsigned char joystick, const unsigned char axis, const int slew);
+
+/**
+ * Reads both joysticks and shapes every axis into the snapshot
+ * Call once per driver control tick, then read the snapshot as often as needed
+ */
+void joystick_Sample();
+
+/**
+ * Replaces the snapshot with recorded values (e.g. from autonomous playback)
+ * joystick_Sample leaves the snapshot alone until joystick_EndReplay
+ *
+ * @param axes Shaped outputs, JOYSTICK_AXES per joystick
+ * @param buttons Held buttons of each joystick (see joystickButtonBit)
+ */
+void joystick_Replay(const int *axes, const unsigned short *buttons);
+
+/**
+ * Returns the snapshot to the joysticks, zeroing it until the next joystick_Sample
+ */
+void joystick_EndReplay();
+
+/**
+ * Gets the snapshot taken by the last joystick_Sample
+ */
+inline const joystickSnapshot* joystick_GetSnapshot();
+
+/**
+ * Gets the shaped output of an axis from the snapshot
+ *
+ * @param joystick Joystick (1 or 2)
+ * @param axis Axis (1 to 4)
+ */
+inline int joystick_GetAxis(const unsigned char joystick, const unsigned char axis);
+
+/**
+ * Gets whether a button is held in the snapshot
+ *
+ * @param joystick Joystick (1 or 2)
+ * @param group Button group (5 to 8)
+ * @param button JOY_DOWN, JOY_LEFT, JOY_UP, or JOY_RIGHT
+ */
+inline bool joystick_GetButton(const unsigned char joystick, const unsigned char group, const unsigned char button);
+
+/**
+ * Gets whether a button went down in the snapshot
+ *
+ * @param joystick Joystick (1 or 2)
+ * @param group Button group (5 to 8)
+ * @param button JOY_DOWN, JOY_LEFT, JOY_UP, or JOY_RIGHT
+ */
+inline bool joystick_GetPressed(const unsigned char joystick, const unsigned char group, const unsigned char button);
+
+/**
+ * Gets the shaping of an axis
+ *
+ * @param joystick Joystick (1 or 2)
+ * @param axis Axis (1 to 4)
+ */
+inline joystickAxis* joystick_GetAxisShaping(const unsigned char joystick, const unsigned char axis);
+
+#endif
@@ -1,13 +1,31 @@
 #ifndef MASTER_H_
 #define MASTER_H_
 
+#include "autoRecord.h"
 #include "bangBang.h"
+#include "benchmark.h"
+#include "doubleBuffer.h"
+#include "driveKinematics.h"
+#include "driveSync.h"
 #include "filter.h"
+#include "gainSchedule.h"
+#include "gyroTracker.h"
+#include "imeManager.h"
+#include "joystick.h"
 #include "lcdControl.h"
 #include "math.h"
+#include "microTimer.h"
 #include "motorControl.h"
+#include "odometry.h"
+#include "oversample.h"
 #include "positionPID.h"
+#include "profiler.h"
+#include "purePursuit.h"
+#include "sensorHub.h"
+#include "serialStream.h"
+#include "telemetry.h"
 #include "timer.h"
+#include "timerWheel.h"
 #include "util.h"
 #include "velocityPID.h"
 #include "velocityTBH.h"
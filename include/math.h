@@ -1,24 +1,33 @@
 #ifndef MATH_H_
 #define MATH_H_
 
+//Pull in the toolchain's math.h (this header shadows it on the include path)
+#include_next <math.h>
+
+#ifndef PI
+#define PI        3.14159265
+#endif
+
 #define CUBED_127 16129
 #define ROOT_2    1.414
 #define EPSILON   1000
 #define sign(value) ( (value) >= 0 ? 1 : (-1) )
 #define cube(value) ( (value) * (value) * (value) )
 #define inchesToTicks(inches, diam) ( ((inches) / (PI * (diam))) * 360 )
-#define ticksToInches(ticks, diam) ( ((diam) * PI) * ((ticks) / 360) )
+#define ticksToInches(ticks, diam) ( ((diam) * PI) * ((ticks) / 360.0) )
 
 /**
- * Calculate timestep
+ * Calculate timestep in ms
  *
  * @param dt dt variable to save to
  * @param prevTime Previous time variable to pull from and then save to
  */
 inline unsigned long util_CalculateTimestep(unsigned int *dt, unsigned int *prevTime)
 {
-	*dt = (millis() - *prevTime) / 1000.0;
-	*prevTime = millis();
+	const unsigned long now = millis();
+
+	*dt = now - *prevTime;
+	*prevTime = now;
 
 	return *dt;
 }
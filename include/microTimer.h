@@ -0,0 +1,109 @@
+#ifndef MICROTIMER_H_
+#define MICROTIMER_H_
+
+#include <stdbool.h>
+
+//Microsecond timer and stopwatch
+typedef struct microTimer_t
+{
+	unsigned long dtMark;        //Clock reading at the last microTimer_GetDT
+	unsigned long lapMark;       //Clock reading at the last microTimer_Lap
+	unsigned long elapsedMark;   //Clock reading when elapsed was last brought up to date
+	unsigned long long elapsed;  //Time accumulated while running, in us (wraparound-safe)
+	bool running;
+
+	//Lap statistics in us
+	unsigned int lapCount;
+	unsigned long lapMin;
+	unsigned long lapMax;
+	unsigned long long lapTotal;
+} microTimer;
+
+/**
+ * Sets the clock used by every microsecond timer
+ * Lets host tests drive timers from a simulated clock
+ *
+ * @param clock Function returning microseconds, or NULL for micros()
+ */
+void microTimer_SetClock(unsigned long (*clock)());
+
+/**
+ * Initializes a microsecond timer and starts it running
+ *
+ * @param mt The timer
+ */
+void microTimer_Init(microTimer *mt);
+
+/**
+ * Gets the time in us since the last call of this function
+ * Independent of microTimer_Lap, so the two can be used on the same timer
+ *
+ * @param mt The timer
+ */
+unsigned long microTimer_GetDT(microTimer *mt);
+
+/**
+ * Gets the time in us since the last lap and adds it to the lap statistics
+ *
+ * @param mt The timer
+ */
+unsigned long microTimer_Lap(microTimer *mt);
+
+/**
+ * Gets the total running time in us
+ * Stays correct across micros() wrapping as long as the timer is read at least once an hour
+ *
+ * @param mt The timer
+ */
+unsigned long long microTimer_GetElapsed(microTimer *mt);
+
+/**
+ * Pauses accumulation of running time
+ *
+ * @param mt The timer
+ */
+void microTimer_Stop(microTimer *mt);
+
+/**
+ * Resumes accumulation of running time
+ *
+ * @param mt The timer
+ */
+void microTimer_Start(microTimer *mt);
+
+/**
+ * Clears the running time and lap statistics and starts a new lap
+ *
+ * @param mt The timer
+ */
+void microTimer_Reset(microTimer *mt);
+
+/**
+ * Gets the number of laps recorded
+ *
+ * @param mt The timer
+ */
+inline unsigned int microTimer_GetLapCount(microTimer *mt);
+
+/**
+ * Gets the shortest lap in us (0 if there are none)
+ *
+ * @param mt The timer
+ */
+inline unsigned long microTimer_GetLapMin(microTimer *mt);
+
+/**
+ * Gets the longest lap in us
+ *
+ * @param mt The timer
+ */
+inline unsigned long microTimer_GetLapMax(microTimer *mt);
+
+/**
+ * Gets the mean lap in us
+ *
+ * @param mt The timer
+ */
+float microTimer_GetLapMean(microTimer *mt);
+
+#endif
@@ -11,6 +11,27 @@
 #define MOTOR_DEFAULT_SLEW_RATE 10     //Feels like nearly no slewing to a driver
 #define MOTOR_FAST_SLEW_RATE    256    //No slewing in output
 #define MOTOR_TASK_DELAY        15     //Wait 15ms between batch motor power updates
+#define MOTOR_GROUP_NUM         4      //Number of motor groups
+#define MOTOR_NO_GROUP          (-1)   //Group of a motor which is not in a group
+
+//Battery compensation
+#define MOTOR_BATTERY_NOMINAL   7200   //Voltage (mV) that commanded powers are scaled to
+#define MOTOR_BATTERY_MIN       4500   //Below this (mV) the reading is ignored (e.g. USB power)
+#define MOTOR_BATTERY_SAMPLE    25     //Slew task cycles between battery samples
+#define MOTOR_BATTERY_ALPHA     0.3    //EMA gain for battery smoothing
+#define MOTOR_BATTERY_MAX_SCALE 1.5    //Largest boost applied to commanded power
+
+//Thermal model (393 motor with its internal PTC, approximate)
+#define MOTOR_THERMAL_VOLTAGE   7200   //Voltage (mV) the motor constants are given at
+#define MOTOR_THERMAL_STALL     4.8    //Stall current (A)
+#define MOTOR_THERMAL_TRIP      1.8    //Steady current (A) which eventually trips the PTC
+#define MOTOR_THERMAL_TAU       12.0   //PTC heating time constant (s)
+#define MOTOR_THERMAL_CAP_START 0.25   //Trip margin below which power capping begins
+#define MOTOR_THERMAL_CAP_MIN   0.3    //Smallest power multiplier applied by capping
+
+//Linearization calibration
+#define MOTOR_CAL_STEPS         32     //Power steps measured in each direction
+#define MOTOR_CAL_SETTLE        250    //Time (ms) to let speed settle at each step
 
 //Motor representation
 typedef struct driveMotor_t
@@ -19,8 +40,33 @@ typedef struct driveMotor_t
 	float artSpeed; //Artifical speed (the exact speed as governed by the slew rate)
 	float slew;     //Slew rate
 	bool active;    //Whether or not to update this motor
+	signed char group; //Group this motor belongs to (MOTOR_NO_GROUP if none)
+	float scale;    //Output multiplier when driven by a group (negative to reverse)
+	const signed char *linearization; //Output lookup table indexed by power + 128 (NULL for none)
+	int lastOutput; //Last power sent to the port
+	int rawSpeed;   //Last power given to setMotorSpeedRaw
+	bool raw;       //Whether rawSpeed is still the motor's output (until the slew rate controller moves it)
+	float freeSpeed; //Free speed (RPM) for the thermal model (0 to disable it)
+	float velocity; //Measured speed (RPM) for the thermal model
+	float current;  //Estimated current (A)
+	float heat;     //Estimated PTC heat, in units of steady current squared
+	float thermalCut; //Fraction of power removed by thermal capping
 } driveMotor;
 
+//Linearization for 393 motors, indexed by power + 128
+extern const signed char motorLinearization393[256];
+
+//Motor group representation (motors updated together as one unit)
+typedef struct motorGroup_t
+{
+	unsigned char members[MOTOR_NUM]; //Ports of member motors
+	unsigned char count;              //Number of member motors
+	int reqSpeed;   //Input speed
+	float artSpeed; //Artifical speed (the exact speed as governed by the slew rate)
+	float slew;     //Slew rate
+	bool active;    //Whether or not to update this group
+} motorGroup;
+
 /*
  * Sets the speed of the motor at index `index` to power `power`
  */
@@ -48,11 +94,79 @@ inline int getMotorSpeed(const unsigned char index);
 inline void setMotorActive(const unsigned char index);
 /*
  * Sets the motor at index `index` to inactive
+ * Neither the slew rate controller nor the motor's group will update it
  */
 inline void setMotorInactive(const unsigned char index);
 
+/**
+ * Enables or disables battery voltage compensation of motor outputs
+ * When enabled, every output (slewed, grouped, and raw) is scaled by nominal / battery voltage
+ *
+ * @param enabled Whether to compensate
+ * @param nominal Voltage (mV) that commanded powers correspond to, e.g. MOTOR_BATTERY_NOMINAL
+ */
+void setMotorBatteryCompensation(const bool enabled, const unsigned int nominal);
+/*
+ * Gets the smoothed main battery voltage (mV) used for compensation
+ */
+inline float getMotorBatteryVoltage();
+
+/**
+ * Sets the output linearization table of a motor
+ * Applied last, after slewing and battery compensation, so controllers see a linear plant
+ *
+ * @param index Port number of the motor
+ * @param table 256 entry lookup table indexed by power + 128 (e.g. motorLinearization393),
+ * or NULL to send powers unchanged
+ */
+inline void setMotorLinearization(const unsigned char index, const signed char *table);
+
+/**
+ * Measures a motor's speed across its power range and builds a linearization table from it
+ * Blocks for about 20 seconds with the motor running; the motor should spin freely (or with its
+ * normal load) and the table is printed as a C initializer so it can be stored in flash
+ * The motor is set inactive for the sweep, so the slew rate task leaves it alone, and its previous
+ * state is restored afterwards (stopped)
+ *
+ * @param index Port number of the motor
+ * @param readVelocity Function returning the motor's current (filtered) velocity
+ * @param table Output table of 256 entries
+ */
+void motorCalibrateLinearization(const unsigned char index, int (*readVelocity)(), signed char *table);
+
+/**
+ * Enables the thermal model of a motor
+ * Current is estimated from the power sent and the measured velocity, and integrated into PTC
+ * heat every slew task cycle
+ *
+ * @param index Port number of the motor
+ * @param freeSpeed Free speed of the motor (or its output) in RPM at MOTOR_THERMAL_VOLTAGE, in
+ * the same units as the velocities given to setMotorMeasuredVelocity
+ */
+void setMotorThermalModel(const unsigned char index, const float freeSpeed);
+/*
+ * Sets the measured velocity of the motor at index `index` for its thermal model
+ * Without one, the motor is modeled as stalled, which overestimates heating
+ */
+inline void setMotorMeasuredVelocity(const unsigned char index, const float velocity);
+/*
+ * Enables or disables power capping of motors close to tripping
+ */
+inline void setMotorThermalCapping(const bool enabled);
+/*
+ * Gets the estimated current (A) of the motor at index `index`
+ */
+inline float getMotorCurrent(const unsigned char index);
+/*
+ * Gets the predicted trip margin of the motor at index `index`
+ * 1 is cold, 0 is at the point of tripping
+ */
+inline float getMotorTripMargin(const unsigned char index);
+
 /*
  * Sets the raw speed of the motor at index `index` to power `power`
+ * The power is recompensated whenever the battery or thermal compensation changes, until the
+ * slew rate controller next moves the motor
  * Warning: The slew rate controller may try to fight this function
  * If you want to bypass slewing, use function `setMotorSpeed_Bypass` instead (or use this
  * function in combination with the function `setMotorInactive`)
@@ -71,6 +185,60 @@ inline int getMotorSpeedRaw(const unsigned char index);
  */
 driveMotor* addMotor(const unsigned char index, const float slewRate);
 
+/**
+ * Initializes a motor group
+ * Reinitializing a group stops its old members and returns them to individual control
+ *
+ * @param group Index of the group (less than MOTOR_GROUP_NUM)
+ * @param slewRate Slew rate of the group
+ */
+motorGroup* addMotorGroup(const unsigned char group, const float slewRate);
+
+/**
+ * Adds a motor to a group, moving it out of any group it was already in
+ * The motor is then slewed and set only through the group; its linearization table and
+ * thermal model (including accumulated heat) are kept
+ *
+ * @param group Index of the group
+ * @param index Port number of the motor
+ * @param scale Output multiplier for this motor (-1 to reverse it)
+ */
+void addMotorToGroup(const unsigned char group, const unsigned char index, const float scale);
+
+/*
+ * Sets the speed of every motor in group `group` to power `power`
+ */
+inline void setMotorGroupSpeed(const unsigned char group, const int power);
+/*
+ * Sets the speed of every motor in group `group` to power `power`, and bypasses slewing
+ */
+inline void setMotorGroupSpeed_Bypass(const unsigned char group, const int power);
+/**
+ * Sets the speeds of several groups as one batch, which the slew rate task always sees whole
+ * Use this when the groups must change together, e.g. the sides of a drive
+ *
+ * @param groups Indices of the groups
+ * @param powers Power for each group
+ * @param count Number of groups
+ */
+void setMotorGroupSpeeds(const unsigned char *groups, const int *powers, const unsigned char count);
+/*
+ * Gets the group at index `group`
+ */
+inline motorGroup* getMotorGroup(const unsigned char group);
+/*
+ * Gets the requested speed of group `group`
+ */
+inline int getMotorGroupSpeed(const unsigned char group);
+/*
+ * Sets group `group` to active
+ */
+inline void setMotorGroupActive(const unsigned char group);
+/*
+ * Sets group `group` to inactive
+ */
+inline void setMotorGroupInactive(const unsigned char group);
+
 /**
  * Updates the power of each motor to best match the requested power
  */
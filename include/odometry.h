@@ -0,0 +1,100 @@
+#ifndef ODOMETRY_H_
+#define ODOMETRY_H_
+
+#include "API.h"
+#include "doubleBuffer.h"
+
+//Odometry general
+#define ODOM_TASK_DELAY       5     //Integrate every 5ms
+#define ODOM_SMALL_ANGLE      1e-4  //Below this heading change (rad) an arc is treated as a line
+
+//Robot pose (inches and radians, theta counterclockwise from the starting heading)
+typedef struct odomPose_t
+{
+	float x;
+	float y;
+	float theta;
+	unsigned long time; //millis() of the last update
+} odomPose;
+
+//Odometry state
+typedef struct odometry_t
+{
+	//Sensors (gyro may be NULL to take heading from the encoders)
+	Encoder left;
+	Encoder right;
+	Gyro gyro;
+
+	//Geometry
+	float inchesPerTick;
+	float trackWidth;
+
+	//Previous readings
+	int prevLeft;
+	int prevRight;
+	int prevGyro;
+
+	//Working pose, only touched by the odometry task
+	odomPose pose;
+
+	//Published poses: the odometry task writes the back one and then flips, readers copy the front one
+	odomPose snapshots[2];
+	doubleBuffer published;
+
+	//Pose set by odom_SetPose, applied by the odometry task at the start of its next update
+	odomPose resetPose;
+	volatile bool resetPending;
+	Mutex resetMutex;
+} odometry;
+
+/**
+ * Initializes odometry
+ *
+ * @param left Left side quad encoder (counts up driving forward)
+ * @param right Right side quad encoder (counts up driving forward)
+ * @param gyro Gyro (counts up turning counterclockwise), or NULL to use the encoders
+ * @param wheelDiam Tracking wheel diameter in inches
+ * @param trackWidth Distance between the left and right tracking wheels in inches
+ */
+void odom_Init(Encoder left, Encoder right, Gyro gyro, const float wheelDiam, const float trackWidth);
+
+/**
+ * Sets the current pose
+ * Takes effect at the start of the odometry task's next update, so it never races the integration
+ * May be called before odom_Init to give the starting pose
+ *
+ * @param x X position in inches
+ * @param y Y position in inches
+ * @param theta Heading in radians
+ */
+void odom_SetPose(const float x, const float y, const float theta);
+
+/**
+ * Copies the latest published pose
+ * Lock-free and safe to call from any task
+ *
+ * @param out Pose to copy into
+ */
+void odom_GetPose(odomPose *out);
+
+/**
+ * Advances a pose along an arc
+ *
+ * @param pose The pose
+ * @param dLeft Left side travel in inches
+ * @param dRight Right side travel in inches
+ * @param dTheta Heading change in radians
+ */
+void odom_Integrate(odomPose *pose, const float dLeft, const float dRight, const float dTheta);
+
+/**
+ * Reads the sensors, integrates, and publishes the new pose
+ */
+void odom_Update();
+
+/**
+ * Starts the odometry task
+ */
+inline void startOdometryTask();
+
+#endif
@@ -0,0 +1,75 @@
+#ifndef OVERSAMPLE_H_
+#define OVERSAMPLE_H_
+
+#include <stdbool.h>
+#include "API.h"
+
+//Analog oversampling general
+#define OVERSAMPLE_PERIOD   1 //Sample every registered channel every 1ms
+#define OVERSAMPLE_MAX_BITS 4 //Most extra bits of resolution (4^4 = 256 samples per output)
+
+//A decimated analog value
+typedef struct oversampleValue_t
+{
+	int value;          //Decimated value in analogReadCalibratedHR units (ADC counts * 16)
+	float average;      //Mean of the samples in ADC counts
+	unsigned long time; //micros() when the last sample was taken
+	unsigned int count; //Outputs produced so far (0 until the first window fills)
+} oversampleValue;
+
+//Accumulator of one channel
+typedef struct oversampleChannel_t
+{
+	bool enabled;
+	unsigned char bits;   //Extra bits of resolution
+	unsigned int samples; //Samples per output (4^bits)
+	int offset;           //Subtracted from every sample (from analogCalibrate)
+	unsigned int sum;
+	unsigned int taken;
+} oversampleChannel;
+
+/**
+ * Registers an analog channel for oversampling
+ *
+ * @param channel Analog channel (1 to BOARD_NR_ADC_PINS)
+ * @param bits Extra bits of resolution (0 to OVERSAMPLE_MAX_BITS), each costs 4x the samples per output
+ * @param calibrate Subtract the analogCalibrate offset (the sensor must be at rest when this is called)
+ * @return Whether the channel was registered
+ */
+bool oversample_AddChannel(const unsigned char channel, const unsigned char bits, const bool calibrate);
+
+/**
+ * Samples every registered channel once and publishes any finished outputs
+ * Called by the oversampling task; only call directly if the task is not running
+ */
+void oversample_Sample();
+
+/**
+ * Gets the latest decimated value of a channel
+ * Lock-free and safe to call from any task
+ *
+ * @param channel Analog channel (1 to BOARD_NR_ADC_PINS)
+ * @param out Value to fill
+ */
+void oversample_Get(const unsigned char channel, oversampleValue *out);
+
+/**
+ * Gets the latest decimated value of a channel in analogReadCalibratedHR units
+ *
+ * @param channel Analog channel (1 to BOARD_NR_ADC_PINS)
+ */
+int oversample_GetValue(const unsigned char channel);
+
+/**
+ * Gets the latest mean of a channel in ADC counts
+ *
+ * @param channel Analog channel (1 to BOARD_NR_ADC_PINS)
+ */
+float oversample_GetAverage(const unsigned char channel);
+
+/*
+ * Starts the oversampling task
+ */
+void startOversampleTask();
+
+#endif
@@ -1,6 +1,8 @@
 #ifndef POSITIONPID_H_
 #define POSITIONPID_H_
 
+#include "gainSchedule.h"
+
 //PID Controller representation
 typedef struct pos_PID_t
 {
@@ -27,6 +29,9 @@ typedef struct pos_PID_t
 	//Input
 	int targetPos;
 
+	//Gain scheduling (NULL for fixed gains)
+	gainSchedule *schedule;
+
 	//Output
 	int outVal;
 } pos_PID;
@@ -62,6 +67,14 @@ void pos_PID_InitController_Full(pos_PID *pid, const float kP, const float kI, c
  */
 inline void pos_PID_SetTargetPosition(pos_PID *pid, const int targetPos);
 
+/**
+ * Sets a gain schedule which overrides kP, kI, and kD each step
+ *
+ * @param pid The PID controller
+ * @param schedule The gain schedule, or NULL to keep the current gains fixed
+ */
+inline void pos_PID_SetGainSchedule(pos_PID *pid, gainSchedule *schedule);
+
 /**
  * Gets the current error
  *
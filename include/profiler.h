@@ -0,0 +1,124 @@
+#ifndef PROFILER_H_
+#define PROFILER_H_
+
+#include <stdbool.h>
+#include "API.h"
+
+//Set to 0 (e.g. -DPROFILER_ENABLED=0) to compile every PROFILE_BEGIN/PROFILE_END out
+#ifndef PROFILER_ENABLED
+#define PROFILER_ENABLED 1
+#endif
+
+//Profiler general
+#define PROFILER_SITES        16  //Sites which can be registered
+#define PROFILER_BUCKETS      16  //Histogram buckets: 0 is under 1us, n is [2^(n-1), 2^n) us, the last is everything longer
+#define PROFILER_CALIBRATION  1000 //Empty begin/end pairs timed by profiler_MeasureOverhead
+
+//Timing of one profiled site (a task body or a controller step)
+typedef struct profilerSite_t
+{
+	const char *name;
+
+	//Execution time in us (with the measured overhead removed)
+	unsigned int count;
+	unsigned long long total;
+	unsigned int min;
+	unsigned int max;
+	unsigned int histogram[PROFILER_BUCKETS];
+
+	//Start to start time in us, for loop jitter
+	unsigned int periodMin;
+	unsigned int periodMax;
+
+	//micros() at the last begin
+	unsigned long start;
+	bool running;
+} profilerSite;
+
+//Instrumentation, compiled out when PROFILER_ENABLED is 0
+#if PROFILER_ENABLED
+#define PROFILE_REGISTER(site, name) site = profiler_Register(name)
+#define PROFILE_BEGIN(site)          profiler_Begin(site)
+#define PROFILE_END(site)            profiler_End(site)
+#else
+#define PROFILE_REGISTER(site, name)
+#define PROFILE_BEGIN(site)
+#define PROFILE_END(site)
+#endif
+
+/**
+ * Registers a profiled site
+ *
+ * @param name Name shown in reports (kept by pointer, 8 characters fit on the LCD)
+ * @return Site ID, or -1 if all sites are used (-1 is ignored by begin and end)
+ */
+int profiler_Register(const char *name);
+
+/**
+ * Marks the start of a profiled section
+ *
+ * @param site Site ID from profiler_Register
+ */
+void profiler_Begin(const int site);
+
+/**
+ * Marks the end of a profiled section and records its duration
+ *
+ * @param site Site ID from profiler_Register
+ */
+void profiler_End(const int site);
+
+/**
+ * Clears the statistics of every site (registrations are kept)
+ */
+void profiler_Reset();
+
+/**
+ * Times empty begin/end pairs and removes that cost from later measurements
+ *
+ * @return Overhead of one begin/end pair in ns
+ */
+unsigned int profiler_MeasureOverhead();
+
+/**
+ * Gets the number of registered sites
+ */
+inline int profiler_GetSiteCount();
+
+/**
+ * Gets a site's statistics
+ *
+ * @param site Site ID from profiler_Register
+ */
+inline const profilerSite* profiler_GetSite(const int site);
+
+/**
+ * Gets the average execution time of a site in us
+ *
+ * @param site Site ID from profiler_Register
+ */
+unsigned int profiler_GetAverage(const int site);
+
+/**
+ * Gets the execution time below which a fraction of a site's runs finished
+ * Resolved to the upper edge of a histogram bucket
+ *
+ * @param site Site ID from profiler_Register
+ * @param fraction Fraction of runs (e.g. 0.99)
+ */
+unsigned int profiler_GetPercentile(const int site, const float fraction);
+
+/**
+ * Prints a table of every site
+ *
+ * @param port Where to print (stdout, uart1, or uart2)
+ */
+void profiler_Print(FILE *port);
+
+/**
+ * Shows sites on the LCD, one per page (left/right to scroll, center to exit)
+ * Meant as a menu dispatch function (see newMenuWithDispatch)
+ */
+void profiler_ShowOnLCD();
+
+#endif
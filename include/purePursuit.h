@@ -0,0 +1,151 @@
+#ifndef PUREPURSUIT_H_
+#define PUREPURSUIT_H_
+
+#include <stdbool.h>
+#include "odometry.h"
+#include "velocityPID.h"
+
+//Pure pursuit general
+#define PP_SMOOTH_TOLERANCE  0.001 //Stop smoothing once no point moves more than this (in)
+#define PP_SMOOTH_MAX_PASSES 500   //Hard limit on smoothing passes
+
+//A user-supplied waypoint (inches)
+typedef struct ppWaypoint_t
+{
+	float x;
+	float y;
+} ppWaypoint;
+
+//A point on the generated path
+typedef struct ppPathPoint_t
+{
+	float x;
+	float y;
+	float distance;  //Distance along the path from the first point (in)
+	float curvature; //1 / turning radius at this point (1/in)
+	float velocity;  //Target speed at this point (in/s)
+} ppPathPoint;
+
+//Pure pursuit path follower
+typedef struct purePursuit_t
+{
+	//Path (storage is owned by the caller)
+	ppPathPoint *path;
+	unsigned int size;
+	unsigned int capacity;
+
+	//Settings
+	float lookahead;    //Lookahead distance (in)
+	float maxVelocity;  //Top speed (in/s)
+	float maxAccel;     //Acceleration limit (in/s^2)
+	float turnK;        //Speed through curves, as speed = turnK / curvature
+	float stopDistance; //Distance from the last point considered finished (in)
+	float trackWidth;   //Distance between left and right wheels (in)
+	float wheelDiam;    //Drive wheel diameter (in)
+
+	//Progress along the path
+	unsigned int closestIndex;
+	unsigned int lookaheadIndex;
+	float lookaheadFrac;
+	float lookaheadX;
+	float lookaheadY;
+
+	//Timestep
+	unsigned long prevTime;
+
+	//Velocity controllers to drive (may be NULL)
+	vel_PID *leftController;
+	vel_PID *rightController;
+
+	//Output
+	float velocity;      //Rate limited path speed (in/s)
+	float curvature;     //Curvature of the arc to the lookahead point (1/in)
+	float leftVelocity;  //Left wheel target (RPM)
+	float rightVelocity; //Right wheel target (RPM)
+	bool done;
+} purePursuit;
+
+/**
+ * Initializes a pure pursuit path follower
+ *
+ * @param pp The path follower
+ * @param buffer Storage for generated path points
+ * @param capacity Number of points `buffer` can hold
+ * @param lookahead Lookahead distance in inches
+ * @param trackWidth Distance between left and right wheels in inches
+ * @param wheelDiam Drive wheel diameter in inches
+ */
+void pp_Init(purePursuit *pp, ppPathPoint *buffer, const unsigned int capacity, const float lookahead, const float trackWidth, const float wheelDiam);
+
+/**
+ * Sets speed limits
+ *
+ * @param pp The path follower
+ * @param maxVelocity Top speed in in/s
+ * @param maxAccel Acceleration limit in in/s^2
+ * @param turnK Speed through curves, as speed = turnK / curvature
+ */
+inline void pp_SetLimits(purePursuit *pp, const float maxVelocity, const float maxAccel, const float turnK);
+
+/**
+ * Sets the velocity controllers whose targets are driven by the path follower
+ * Step them with their sensors as usual; each step of the follower sets their target velocity
+ *
+ * @param pp The path follower
+ * @param left Left side velocity controller
+ * @param right Right side velocity controller
+ */
+inline void pp_SetVelocityControllers(purePursuit *pp, vel_PID *left, vel_PID *right);
+
+/**
+ * Generates a path from waypoints: injects points, smooths, and annotates each point with
+ * distance, curvature, and target velocity
+ * Call once before following; this is too slow to run every step
+ *
+ * @param pp The path follower
+ * @param waypoints Waypoints to pass through (at least two)
+ * @param count Number of waypoints
+ * @param spacing Distance between generated points in inches
+ * @param smoothing Smoothing weight in [0, 1) (0 leaves corners sharp)
+ * @return Number of points generated (limited by the buffer capacity)
+ */
+unsigned int pp_GeneratePath(purePursuit *pp, const ppWaypoint *waypoints, const unsigned int count, const float spacing, const float smoothing);
+
+/**
+ * Restarts following from the beginning of the path
+ *
+ * @param pp The path follower
+ */
+void pp_Reset(purePursuit *pp);
+
+/**
+ * Gets whether the end of the path was reached
+ *
+ * @param pp The path follower
+ */
+inline bool pp_IsDone(purePursuit *pp);
+
+/**
+ * Gets the left wheel target velocity in RPM
+ *
+ * @param pp The path follower
+ */
+inline float pp_GetLeftVelocity(purePursuit *pp);
+
+/**
+ * Gets the right wheel target velocity in RPM
+ *
+ * @param pp The path follower
+ */
+inline float pp_GetRightVelocity(purePursuit *pp);
+
+/**
+ * Steps the path follower
+ *
+ * @param pp The path follower
+ * @param pose Current robot pose
+ * @return Whether the end of the path was reached
+ */
+bool pp_StepController(purePursuit *pp, const odomPose *pose);
+
+#endif
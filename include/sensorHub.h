@@ -0,0 +1,138 @@
+#ifndef SENSORHUB_H_
+#define SENSORHUB_H_
+
+#include <stdbool.h>
+#include "API.h"
+
+//Sensor hub general
+#define SENSOR_HUB_MAX    16 //Sensors which can be registered
+#define SENSOR_HUB_PERIOD 5  //Sample every 5ms
+
+//Kinds of sensor the hub can sample
+typedef enum
+{
+	SENSOR_ENCODER = 0,      //encoderGet
+	SENSOR_IME = 1,          //imeGet
+	SENSOR_IME_VELOCITY = 2, //imeGetVelocity
+	SENSOR_ANALOG = 3,       //analogRead
+	SENSOR_ANALOG_HR = 4,    //analogReadCalibratedHR
+	SENSOR_DIGITAL = 5,      //digitalRead
+	SENSOR_GYRO = 6,         //gyroGet
+	SENSOR_CUSTOM = 7        //User function
+} sensorType;
+
+//A registered sensor
+typedef struct sensorSource_t
+{
+	sensorType type;
+	unsigned char port;   //IME address, analog channel, or digital pin
+	void *handle;         //Encoder or Gyro
+	int (*read)(bool *ok); //SENSOR_CUSTOM reader
+} sensorSource;
+
+//One sample
+typedef struct sensorReading_t
+{
+	int value;
+	unsigned long time; //micros() when read
+	bool valid;         //False if the last read failed (value is the last good one)
+} sensorReading;
+
+//Every sensor sampled in one pass
+typedef struct sensorSnapshot_t
+{
+	sensorReading readings[SENSOR_HUB_MAX];
+	unsigned long time;    //micros() at the start of the pass
+	unsigned int sequence; //Pass number
+} sensorSnapshot;
+
+/**
+ * Registers an encoder
+ *
+ * @param enc The encoder
+ * @return Sensor ID, or -1 if the hub is full
+ */
+int sensorHub_AddEncoder(Encoder enc);
+
+/**
+ * Registers an IME count
+ *
+ * @param address IME address
+ * @return Sensor ID, or -1 if the hub is full
+ */
+int sensorHub_AddIME(const unsigned char address);
+
+/**
+ * Registers an IME velocity
+ *
+ * @param address IME address
+ * @return Sensor ID, or -1 if the hub is full
+ */
+int sensorHub_AddIMEVelocity(const unsigned char address);
+
+/**
+ * Registers an analog input
+ *
+ * @param channel Analog channel (1 to BOARD_NR_ADC_PINS)
+ * @param highRes Read with analogReadCalibratedHR instead of analogRead
+ * @return Sensor ID, or -1 if the hub is full
+ */
+int sensorHub_AddAnalog(const unsigned char channel, const bool highRes);
+
+/**
+ * Registers a digital input
+ *
+ * @param pin Digital pin
+ * @return Sensor ID, or -1 if the hub is full
+ */
+int sensorHub_AddDigital(const unsigned char pin);
+
+/**
+ * Registers a gyro
+ *
+ * @param gyro The gyro
+ * @return Sensor ID, or -1 if the hub is full
+ */
+int sensorHub_AddGyro(Gyro gyro);
+
+/**
+ * Registers a user function, sampled in order with the other sensors
+ *
+ * @param read Returns a reading and sets its argument to whether the read worked
+ * @return Sensor ID, or -1 if the hub is full
+ */
+int sensorHub_AddCustom(int (*read)(bool *ok));
+
+/**
+ * Samples every registered sensor once and publishes the snapshot
+ * Called by the hub task; only call directly if the task is not running
+ */
+void sensorHub_Sample();
+
+/**
+ * Copies the latest snapshot (every reading from the same pass)
+ *
+ * @param out Snapshot to fill
+ */
+void sensorHub_GetSnapshot(sensorSnapshot *out);
+
+/**
+ * Gets the latest reading of one sensor
+ *
+ * @param id Sensor ID
+ */
+sensorReading sensorHub_GetReading(const int id);
+
+/**
+ * Gets the latest value of one sensor
+ *
+ * @param id Sensor ID
+ */
+int sensorHub_Get(const int id);
+
+/*
+ * Starts the sensor hub task
+ */
+void startSensorHubTask();
+
+#endif
@@ -0,0 +1,79 @@
+#ifndef SERIALSTREAM_H_
+#define SERIALSTREAM_H_
+
+#include <stdbool.h>
+
+//Serial stream general
+#define STREAM_CHANNELS     32     //Channels available (one bit each in a subscription mask)
+#define STREAM_DEFAULT_BAUD 230400 //Baud rate used by stream_Start
+#define STREAM_PERIOD       10     //Send a frame every 10ms
+#define STREAM_TYPE_DATA    0x01   //Robot to host: subscribed channel values
+#define STREAM_TYPE_SUB     0x02   //Host to robot: new subscription mask
+
+//Largest frame before and after COBS encoding (type, seq, time, mask, values, CRC)
+#define STREAM_MAX_RAW      (1 + 1 + 4 + 4 + 4 * STREAM_CHANNELS + 2)
+#define STREAM_MAX_ENCODED  (STREAM_MAX_RAW + STREAM_MAX_RAW / 254 + 2)
+
+/**
+ * Opens uart2 and starts streaming subscribed channels
+ *
+ * @param baud Baud rate (e.g. STREAM_DEFAULT_BAUD)
+ * @param subscribed Initial subscription mask (bit n streams channel n)
+ */
+void stream_Start(const unsigned int baud, const unsigned int subscribed);
+
+/**
+ * Sets the latest value of a channel
+ * Only stores the value, so it is cheap enough to call from any control loop
+ *
+ * @param channel Channel number (less than STREAM_CHANNELS)
+ * @param value New value
+ */
+inline void stream_Set(const unsigned char channel, const float value);
+
+/**
+ * Sets which channels are streamed
+ *
+ * @param mask Subscription mask (bit n streams channel n)
+ */
+inline void stream_Subscribe(const unsigned int mask);
+
+/**
+ * Gets which channels are streamed
+ */
+inline unsigned int stream_GetSubscribed();
+
+/**
+ * Gets the number of malformed frames received from the host
+ */
+inline unsigned int stream_GetBadFrames();
+
+/**
+ * Calculates a CRC-16/CCITT-FALSE checksum
+ *
+ * @param data Bytes to checksum
+ * @param length Number of bytes
+ */
+unsigned short stream_Crc16(const unsigned char *data, const unsigned int length);
+
+/**
+ * COBS encodes a buffer so it contains no zero bytes
+ *
+ * @param in Bytes to encode
+ * @param length Number of bytes
+ * @param out Output, at least length + length / 254 + 1 bytes
+ * @return Encoded length (without a delimiter)
+ */
+unsigned int stream_CobsEncode(const unsigned char *in, const unsigned int length, unsigned char *out);
+
+/**
+ * Decodes a COBS encoded buffer
+ *
+ * @param in Encoded bytes (without the zero delimiter)
+ * @param length Number of encoded bytes
+ * @param out Output, at least length bytes
+ * @return Decoded length, or 0 if the input is malformed
+ */
+unsigned int stream_CobsDecode(const unsigned char *in, const unsigned int length, unsigned char *out);
+
+#endif
@@ -0,0 +1,88 @@
+#ifndef TELEMETRY_H_
+#define TELEMETRY_H_
+
+#include <stdbool.h>
+
+//Telemetry general
+#define TELEMETRY_BUFFER_SIZE 128        //Records held in RAM (power of two)
+#define TELEMETRY_DRAIN_DELAY 100        //Wait 100ms between drains to the file system
+#define TELEMETRY_DRAIN_BATCH 32         //Records written per fwrite
+#define TELEMETRY_MAGIC       0x54494342 //"BCIT" at the start of every log file
+#define TELEMETRY_VERSION     1
+#define TELEMETRY_CH_DROPPED  0xFFFF     //Reserved channel: total records dropped so far
+
+//A telemetry record (12 bytes, little endian on both the Cortex and hosts)
+typedef struct telemetryRecord_t
+{
+	unsigned int time;       //millis() when the record was pushed (or the time given to telemetry_PushAt)
+	unsigned short channel;  //User-defined channel ID
+	unsigned short sequence; //Low 16 bits of the record count, gaps mean lost writes
+	float value;
+} telemetryRecord;
+
+//Log file header
+typedef struct telemetryHeader_t
+{
+	unsigned int magic;
+	unsigned short version;
+	unsigned short recordSize;
+} telemetryHeader;
+
+/**
+ * Initializes (or clears) the telemetry buffer
+ * Call once before pushing records from any task
+ */
+void telemetry_Init();
+
+/**
+ * Opens a log file and starts a low priority task which drains the buffer into it
+ *
+ * @param file File name on the PROS file system
+ * @return Whether the file was opened
+ */
+bool telemetry_Start(const char *file);
+
+/**
+ * Drains the buffer and closes the log file (the file is only kept once closed)
+ */
+void telemetry_Stop();
+
+/**
+ * Pushes a record into the buffer
+ * Lock-free and safe to call from any task; never blocks
+ *
+ * @param channel User-defined channel ID
+ * @param value Value to record
+ * @return Whether there was room for the record
+ */
+bool telemetry_Push(const unsigned short channel, const float value);
+
+/**
+ * Pushes a record with its own timestamp into the buffer
+ * For controller steps, pass the controller's prevTime so a replay steps at exactly the same time
+ *
+ * @param time Timestamp in ms
+ * @param channel User-defined channel ID
+ * @param value Value to record
+ * @return Whether there was room for the record
+ */
+bool telemetry_PushAt(const unsigned int time, const unsigned short channel, const float value);
+
+/**
+ * Writes buffered records to the log file (or discards them if no file is open)
+ *
+ * @return Number of records drained
+ */
+unsigned int telemetry_Flush();
+
+/**
+ * Gets the number of records dropped because the buffer was full
+ */
+inline unsigned int telemetry_GetDropped();
+
+/**
+ * Gets the number of records lost to failed file writes
+ */
+inline unsigned int telemetry_GetWriteErrors();
+
+#endif
@@ -78,9 +78,10 @@ inline long timer_GetDTFromHardMarker(timer *timer);
 
 /**
  * Returns true when a time period has passed, then resets
+ * Periods are counted from the first call, not from when the caller noticed, so they never drift
  *
  * @param timer The timer
- * @param timeMs Repeat time in ms
+ * @param timeMs Repeat time in ms (0 or less fires every call)
  */
 bool timer_Repeat(timer *timer, long timeMs);
 
@@ -0,0 +1,78 @@
+#ifndef TIMERWHEEL_H_
+#define TIMERWHEEL_H_
+
+#include <stdbool.h>
+
+//Timer wheel general
+#define TIMER_WHEEL_PERIOD      1 //Advance the wheel every 1ms
+#define TIMER_WHEEL_ROOT_BITS   8 //First level: 256 slots of 1ms
+#define TIMER_WHEEL_LEVEL_BITS  6 //Outer levels: 64 slots each, 256ms, 16.4s, and 17.5min per slot
+#define TIMER_WHEEL_LEVELS      4 //Longest delay without re-cascading is 2^26ms (18.6 hours)
+
+#define TIMER_WHEEL_ROOT_SIZE   (1 << TIMER_WHEEL_ROOT_BITS)
+#define TIMER_WHEEL_LEVEL_SIZE  (1 << TIMER_WHEEL_LEVEL_BITS)
+
+//A one-shot or periodic timer, owned by the caller and linked into the wheel while active
+typedef struct wheelTimer_t
+{
+	struct wheelTimer_t *next;
+	struct wheelTimer_t *prev;
+
+	unsigned long expires; //millis() when the callback is due
+	unsigned long period;  //Interval of a periodic timer in ms (0 for one-shot)
+
+	void (*callback)(void *arg);
+	void *arg;
+} wheelTimer;
+
+/**
+ * Initializes the timer wheel (call once before adding timers)
+ */
+void timerWheel_Init();
+
+/**
+ * Initializes a timer (call once before its first timerWheel_Add)
+ *
+ * @param t The timer
+ */
+void timerWheel_InitTimer(wheelTimer *t);
+
+/**
+ * Starts a timer, restarting it if it is already active
+ * O(1); callbacks run in the timer wheel task and must not block
+ *
+ * @param t The timer
+ * @param delayMs Time until the first callback in ms
+ * @param periodMs Interval between later callbacks in ms, or 0 for one-shot
+ * @param callback Function to call
+ * @param arg Argument passed to callback
+ */
+void timerWheel_Add(wheelTimer *t, const unsigned long delayMs, const unsigned long periodMs, void (*callback)(void *arg), void *arg);
+
+/**
+ * Stops a timer (does nothing if it is not active)
+ * O(1)
+ *
+ * @param t The timer
+ */
+void timerWheel_Cancel(wheelTimer *t);
+
+/**
+ * Gets whether a timer is waiting to fire
+ *
+ * @param t The timer
+ */
+inline bool timerWheel_IsActive(wheelTimer *t);
+
+/**
+ * Fires every timer due up to now
+ * Called by the timer wheel task; only call directly if the task is not running
+ */
+void timerWheel_Advance();
+
+/*
+ * Starts the timer wheel task
+ */
+void startTimerWheelTask();
+
+#endif
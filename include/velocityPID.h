@@ -3,6 +3,7 @@
 
 #include <stdbool.h>
 #include "filter.h"
+#include "gainSchedule.h"
 #include "util.h"
 
 //A velocity PID controller
@@ -32,6 +33,9 @@ typedef struct vel_PID_t
 	float alpha;
 	float beta;
 
+	//Gain scheduling (NULL for fixed gains, kI is unused)
+	gainSchedule *schedule;
+
 	//Output
 	float outVal;
 } vel_PID;
@@ -63,6 +67,14 @@ inline void vel_PID_SetFilterConstants(vel_PID *pid, const float alpha, const fl
  */
 inline void vel_PID_SetTargetVelocity(vel_PID *pid, const int targetVelocity);
 
+/**
+ * Sets a gain schedule which overrides kP and kD each step
+ *
+ * @param pid The PID controller
+ * @param schedule The gain schedule, or NULL to keep the current gains fixed
+ */
+inline void vel_PID_SetGainSchedule(vel_PID *pid, gainSchedule *schedule);
+
 /**
  * Gets the current error
  *
@@ -0,0 +1,573 @@
+#include "API.h"
+#include "autoRecord.h"
+#include "joystick.h"
+#include "motorControl.h"
+
+//Stream state shared by recording and playback (only one runs at a time)
+static autoRecordSource autoSource;
+static unsigned char autoChannels = 0;
+static int autoFrame[AUTO_RECORD_CHANNELS];
+static unsigned int autoFrames = 0;
+static unsigned int autoBytes = 0;
+static FILE *autoFile = NULL;
+
+//Recording: encoded bytes waiting for fwrite, and identical frames not yet written
+static unsigned char autoOut[AUTO_RECORD_BUFFER];
+static unsigned int autoOutLength = 0;
+static unsigned int autoRun = 0;
+static bool autoWriteFailed = false;
+
+//Playback: bytes read ahead of the decoder, and identical frames still to play
+static unsigned char autoIn[AUTO_RECORD_READ_AHEAD];
+static unsigned int autoInLength = 0;
+static unsigned int autoInIndex = 0;
+static unsigned int autoRepeat = 0;
+static volatile bool autoPlaying = false;
+static volatile bool autoRecording = false;
+
+//Task running the recording or playback, its period, and the mutex guarding the stream from stop functions
+static TaskHandle autoTask = NULL;
+static volatile unsigned short autoPeriod = AUTO_RECORD_PERIOD;
+static volatile bool autoRestart = false;
+static Mutex autoMutex = NULL;
+
+/**
+ * Gets the number of channels in a frame of a source
+ */
+static unsigned char autoRecordChannels(const autoRecordSource source)
+{
+	return source == AUTO_RECORD_MOTORS ? MOTOR_NUM + MOTOR_GROUP_NUM : JOYSTICK_NUM * JOYSTICK_AXES + JOYSTICK_NUM;
+}
+
+/**
+ * Records or plays back a frame every period
+ */
+static void autoRecordTask(void *ignored)
+{
+	unsigned long wake = millis();
+
+	while (true)
+	{
+		//Count periods from the start of each recording or playback, so frames keep their recorded times
+		if (autoRestart)
+		{
+			wake = millis();
+			autoRestart = false;
+		}
+
+		if (autoRecording)
+		{
+			autoRecord_Record();
+		}
+		else if (autoPlaying)
+		{
+			autoRecord_Play();
+		}
+
+		taskDelayUntil(&wake, autoPeriod);
+	}
+}
+
+/**
+ * Takes the stream mutex, creating it on first use (a stop function may be called before any start)
+ */
+static void autoRecordLock()
+{
+	if (autoMutex == NULL)
+	{
+		autoMutex = mutexCreate();
+	}
+
+	mutexTake(autoMutex, -1);
+}
+
+/**
+ * Starts the recording and playback task (once) at a new period
+ */
+static void autoRecordStartTask(const unsigned short period)
+{
+	autoPeriod = period;
+	autoRestart = true;
+
+	if (autoTask == NULL)
+	{
+		autoTask = taskCreate(autoRecordTask, TASK_DEFAULT_STACK_SIZE, NULL, TASK_PRIORITY_DEFAULT + 1);
+	}
+}
+
+/**
+ * Writes encoded bytes to the file
+ */
+static void autoRecordFlush()
+{
+	if (autoOutLength > 0)
+	{
+		//A full file system truncates the recording, which would otherwise only show as playback ending early
+		if (fwrite(autoOut, 1, autoOutLength, autoFile) != autoOutLength)
+		{
+			autoWriteFailed = true;
+		}
+
+		autoBytes += autoOutLength;
+		autoOutLength = 0;
+	}
+}
+
+/**
+ * Writes pending identical frames as a run token
+ */
+static void autoRecordEndRun()
+{
+	if (autoRun > 0)
+	{
+		autoOut[autoOutLength++] = AUTO_RECORD_TOKEN_RUN | (autoRun - 1);
+		autoRun = 0;
+	}
+}
+
+/**
+ * Opens a recording file and starts sampling into it
+ *
+ * @param file File name on the PROS file system
+ * @param source What to record
+ * @param period Sample period in ms (e.g. AUTO_RECORD_PERIOD)
+ * @return Whether the file was opened and its header written
+ */
+bool autoRecord_StartRecording(const char *file, const autoRecordSource source, const unsigned short period)
+{
+	//The task may still be inside a frame of the previous recording or playback
+	autoRecordLock();
+
+	if (autoFile != NULL)
+	{
+		mutexGive(autoMutex);
+		return false;
+	}
+
+	FILE *f = fopen(file, "w");
+
+	if (f == NULL)
+	{
+		mutexGive(autoMutex);
+		return false;
+	}
+
+	autoSource = source;
+	autoChannels = autoRecordChannels(source);
+
+	const autoRecordHeader header = {AUTO_RECORD_MAGIC, AUTO_RECORD_VERSION, source, autoChannels, period, 0};
+
+	if (fwrite(&header, sizeof(header), 1, f) != 1)
+	{
+		fclose(f);
+		mutexGive(autoMutex);
+		return false;
+	}
+
+	//The first frame is encoded as deltas from zero
+	for (int i = 0; i < AUTO_RECORD_CHANNELS; i++)
+	{
+		autoFrame[i] = 0;
+	}
+
+	autoFrames = 0;
+	autoBytes = 0;
+	autoOutLength = 0;
+	autoRun = 0;
+	autoWriteFailed = false;
+	autoFile = f;
+	autoRecording = true;
+
+	autoRecordStartTask(period);
+
+	mutexGive(autoMutex);
+
+	return true;
+}
+
+/**
+ * Stops sampling, ends the recording, and closes its file (the file is only kept once closed)
+ *
+ * @return Whether the whole recording was written (false if, for example, the file system filled up)
+ */
+bool autoRecord_StopRecording()
+{
+	bool ok = true;
+
+	autoRecordLock();
+
+	if (autoRecording)
+	{
+		autoRecording = false;
+
+		autoRecordEndRun();
+		autoOut[autoOutLength++] = AUTO_RECORD_TOKEN_END;
+		autoRecordFlush();
+
+		fclose(autoFile);
+		autoFile = NULL;
+		ok = !autoWriteFailed;
+	}
+
+	mutexGive(autoMutex);
+
+	return ok;
+}
+
+/**
+ * Samples and encodes one frame
+ * Called by the recording task; only call directly if the task is not running
+ */
+void autoRecord_Record()
+{
+	int sample[AUTO_RECORD_CHANNELS];
+	unsigned short mask = 0;
+
+	//The mask must be built against the same frame the deltas are taken from, so hold the mutex throughout
+	autoRecordLock();
+
+	if (!autoRecording)
+	{
+		mutexGive(autoMutex);
+		return;
+	}
+
+	if (autoSource == AUTO_RECORD_MOTORS)
+	{
+		for (unsigned char i = 0; i < MOTOR_NUM; i++)
+		{
+			sample[i] = getMotorSpeed(i);
+		}
+
+		for (unsigned char i = 0; i < MOTOR_GROUP_NUM; i++)
+		{
+			sample[MOTOR_NUM + i] = getMotorGroupSpeed(i);
+		}
+	}
+	else
+	{
+		const joystickSnapshot *snapshot = joystick_GetSnapshot();
+
+		for (int j = 0; j < JOYSTICK_NUM; j++)
+		{
+			for (int i = 0; i < JOYSTICK_AXES; i++)
+			{
+				sample[j * JOYSTICK_AXES + i] = snapshot->axes[j][i];
+			}
+
+			sample[JOYSTICK_NUM * JOYSTICK_AXES + j] = snapshot->buttons[j];
+		}
+	}
+
+	for (unsigned char i = 0; i < autoChannels; i++)
+	{
+		mask |= sample[i] != autoFrame[i] ? 1 << i : 0;
+	}
+
+	autoFrames++;
+
+	//Most frames in a driver run repeat the last one, so they only add to a run
+	if (mask == 0)
+	{
+		if (++autoRun == AUTO_RECORD_MAX_RUN)
+		{
+			autoRecordEndRun();
+		}
+	}
+	else
+	{
+		//Room for a run token, the delta header, and a 5 byte varint per channel
+		if (autoOutLength + 4 + 5 * AUTO_RECORD_CHANNELS > AUTO_RECORD_BUFFER)
+		{
+			autoRecordFlush();
+		}
+
+		autoRecordEndRun();
+
+		autoOut[autoOutLength++] = AUTO_RECORD_TOKEN_DELTA;
+		autoOut[autoOutLength++] = mask & 0xFF;
+		autoOut[autoOutLength++] = mask >> 8;
+
+		for (unsigned char i = 0; i < autoChannels; i++)
+		{
+			if (!(mask & (1 << i)))
+			{
+				continue;
+			}
+
+			//Zigzag so small negative deltas are small numbers, then 7 bits per byte
+			const int delta = sample[i] - autoFrame[i];
+			unsigned int zigzag = ((unsigned int)delta << 1) ^ (unsigned int)(delta >> 31);
+
+			while (zigzag >= 0x80)
+			{
+				autoOut[autoOutLength++] = (zigzag & 0x7F) | 0x80;
+				zigzag >>= 7;
+			}
+
+			autoOut[autoOutLength++] = zigzag;
+			autoFrame[i] = sample[i];
+		}
+	}
+
+	if (autoOutLength + 1 >= AUTO_RECORD_BUFFER)
+	{
+		autoRecordFlush();
+	}
+
+	mutexGive(autoMutex);
+}
+
+/**
+ * Gets the next encoded byte, reading ahead from the file when the buffer runs out
+ *
+ * @return The byte, or -1 at the end of the file
+ */
+static int autoPlaybackByte()
+{
+	if (autoInIndex >= autoInLength)
+	{
+		autoInLength = fread(autoIn, 1, AUTO_RECORD_READ_AHEAD, autoFile);
+		autoInIndex = 0;
+
+		if (autoInLength == 0)
+		{
+			return -1;
+		}
+	}
+
+	autoBytes++;
+	return autoIn[autoInIndex++];
+}
+
+/**
+ * Sends the current frame to the motors or the joystick snapshot
+ */
+static void autoPlaybackApply()
+{
+	if (autoSource == AUTO_RECORD_MOTORS)
+	{
+		for (unsigned char i = 0; i < MOTOR_NUM; i++)
+		{
+			setMotorSpeed(i, autoFrame[i]);
+		}
+
+		for (unsigned char i = 0; i < MOTOR_GROUP_NUM; i++)
+		{
+			setMotorGroupSpeed(i, autoFrame[MOTOR_NUM + i]);
+		}
+	}
+	else
+	{
+		unsigned short buttons[JOYSTICK_NUM];
+
+		for (int j = 0; j < JOYSTICK_NUM; j++)
+		{
+			buttons[j] = autoFrame[JOYSTICK_NUM * JOYSTICK_AXES + j];
+		}
+
+		joystick_Replay(autoFrame, buttons);
+	}
+}
+
+/**
+ * Opens a recording and starts playing it back at the period it was recorded at
+ *
+ * @param file File name on the PROS file system
+ * @return Whether the file was opened and is a valid recording
+ */
+bool autoRecord_StartPlayback(const char *file)
+{
+	//The task may still be inside a frame of the previous recording or playback
+	autoRecordLock();
+
+	if (autoFile != NULL)
+	{
+		mutexGive(autoMutex);
+		return false;
+	}
+
+	FILE *f = fopen(file, "r");
+
+	if (f == NULL)
+	{
+		mutexGive(autoMutex);
+		return false;
+	}
+
+	autoRecordHeader header;
+
+	if (fread(&header, sizeof(header), 1, f) != 1 || header.magic != AUTO_RECORD_MAGIC || header.version != AUTO_RECORD_VERSION ||
+		header.source > AUTO_RECORD_JOYSTICK || header.channels != autoRecordChannels(header.source) || header.period == 0)
+	{
+		fclose(f);
+		mutexGive(autoMutex);
+		return false;
+	}
+
+	autoSource = header.source;
+	autoChannels = header.channels;
+
+	for (int i = 0; i < AUTO_RECORD_CHANNELS; i++)
+	{
+		autoFrame[i] = 0;
+	}
+
+	autoFrames = 0;
+	autoBytes = 0;
+	autoInLength = 0;
+	autoInIndex = 0;
+	autoRepeat = 0;
+	autoFile = f;
+	autoPlaying = true;
+
+	autoRecordStartTask(header.period);
+
+	mutexGive(autoMutex);
+
+	return true;
+}
+
+/**
+ * Zeroes recorded motors (or releases the joystick snapshot) and closes the recording
+ * Call with the mutex held
+ */
+static void autoPlaybackFinish()
+{
+	if (autoSource == AUTO_RECORD_MOTORS)
+	{
+		for (int i = 0; i < AUTO_RECORD_CHANNELS; i++)
+		{
+			autoFrame[i] = 0;
+		}
+
+		autoPlaybackApply();
+	}
+	else
+	{
+		joystick_EndReplay();
+	}
+
+	fclose(autoFile);
+	autoFile = NULL;
+	autoPlaying = false;
+}
+
+/**
+ * Stops playback, zeroing recorded motors (or releasing the joystick snapshot), and closes the file
+ */
+void autoRecord_StopPlayback()
+{
+	autoRecordLock();
+
+	if (autoPlaying)
+	{
+		autoPlaybackFinish();
+	}
+
+	mutexGive(autoMutex);
+}
+
+/**
+ * Decodes and applies one frame
+ * Called by the playback task; only call directly if the task is not running
+ *
+ * @return Whether a frame was applied (false once the recording has ended)
+ */
+bool autoRecord_Play()
+{
+	autoRecordLock();
+
+	if (!autoPlaying)
+	{
+		mutexGive(autoMutex);
+		return false;
+	}
+
+	bool ok = true;
+
+	//Inside a run the frame is unchanged, so there is nothing to decode
+	if (autoRepeat > 0)
+	{
+		autoRepeat--;
+	}
+	else
+	{
+		const int token = autoPlaybackByte();
+
+		if ((token & AUTO_RECORD_TOKEN_RUN) && token >= 0)
+		{
+			autoRepeat = token & (AUTO_RECORD_MAX_RUN - 1);
+		}
+		else if (token == AUTO_RECORD_TOKEN_DELTA)
+		{
+			const int low = autoPlaybackByte(), high = autoPlaybackByte();
+			const unsigned short mask = low | (high << 8);
+			ok = low >= 0 && high >= 0;
+
+			for (unsigned char i = 0; ok && i < autoChannels; i++)
+			{
+				if (!(mask & (1 << i)))
+				{
+					continue;
+				}
+
+				unsigned int zigzag = 0;
+				int shift = 0, c;
+
+				do
+				{
+					c = autoPlaybackByte();
+					zigzag |= (unsigned int)(c & 0x7F) << shift;
+					shift += 7;
+				} while (c >= 0x80 && shift < 35);
+
+				ok = c >= 0 && c < 0x80;
+				autoFrame[i] += (int)(zigzag >> 1) ^ -(int)(zigzag & 1);
+			}
+		}
+		else
+		{
+			//End token, end of file, or a damaged stream
+			ok = false;
+		}
+	}
+
+	if (ok)
+	{
+		autoFrames++;
+		autoPlaybackApply();
+	}
+	else
+	{
+		autoPlaybackFinish();
+	}
+
+	mutexGive(autoMutex);
+
+	return ok;
+}
+
+/**
+ * Gets whether a recording is being played back
+ */
+bool autoRecord_IsPlaying()
+{
+	return autoPlaying;
+}
+
+/**
+ * Gets the number of frames recorded or played back so far
+ */
+unsigned int autoRecord_GetFrames()
+{
+	return autoFrames;
+}
+
+/**
+ * Gets the number of encoded bytes written or read so far (excluding the header)
+ */
+unsigned int autoRecord_GetBytes()
+{
+	return autoBytes;
+}
@@ -40,7 +40,7 @@ void bangBang_InitController(bangBang *bb, const int highPower, const int lowPow
  * @param alpha DEMA filter alpha
  * @param beta DEMA filter beta
  */
-inline void bangBang_SetFilterConstants(bangBang *bb, const float alpha, const float beta)
+void bangBang_SetFilterConstants(bangBang *bb, const float alpha, const float beta)
 {
 	bb->alpha = alpha;
 	bb->beta = beta;
@@ -52,7 +52,7 @@ inline void bangBang_SetFilterConstants(bangBang *bb, const float alpha, const f
  * @param bb The BangBang controller
  * @param targetVelocity New target velocity
  */
-inline void bangBang_SetTargetVelocity(bangBang *bb, const int targetVelocity)
+void bangBang_SetTargetVelocity(bangBang *bb, const int targetVelocity)
 {
 	bb->targetVelocity = targetVelocity;
 }
@@ -62,7 +62,7 @@ inline void bangBang_SetTargetVelocity(bangBang *bb, const int targetVelocity)
  *
  * @param bb The BangBang controller
  */
-inline int bangBang_GetError(bangBang *bb)
+int bangBang_GetError(bangBang *bb)
 {
 	return bb->error;
 }
@@ -72,7 +72,7 @@ inline int bangBang_GetError(bangBang *bb)
  *
  * @param bb The BangBang controller
  */
-inline int bangBang_GetVelocity(bangBang *bb)
+int bangBang_GetVelocity(bangBang *bb)
 {
 	return (int)bb->currentVelocity;
 }
@@ -82,7 +82,7 @@ inline int bangBang_GetVelocity(bangBang *bb)
  *
  * @param bb The BangBang controller
  */
-inline float bangBang_GetTargetVelocity(bangBang *bb)
+float bangBang_GetTargetVelocity(bangBang *bb)
 {
 	return bb->targetVelocity;
 }
@@ -92,7 +92,7 @@ inline float bangBang_GetTargetVelocity(bangBang *bb)
  *
  * @param bb The BangBang controller
  */
-inline int bangBang_GetOutput(bangBang *bb)
+int bangBang_GetOutput(bangBang *bb)
 {
 	return bb->outVal;
 }
@@ -129,10 +129,12 @@ int bangBang_StepVelocity(bangBang *bb, const float sens)
  */
 int bangBang_StepController(bangBang *bb, const float sens)
 {
-	//Calculate current velocity and scrap dt if zero
-	if (bangBang_StepVelocity(bb, sens) == 0)
+	//Calculate current velocity and keep the last output if dt is zero
+	bangBang_StepVelocity(bb, sens);
+
+	if (bb->dt == 0)
 	{
-		return 0;
+		return bb->outVal;
 	}
 
 	//Calculate error
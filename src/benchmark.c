@@ -0,0 +1,336 @@
+#include <string.h>
+#include "API.h"
+#include "benchmark.h"
+#include "filter.h"
+#include "positionPID.h"
+#include "velocityTBH.h"
+
+#ifdef __arm__
+//Cortex-M3 debug registers
+#define DEMCR      (*(volatile unsigned int *)0xE000EDFC)
+#define DWT_CTRL   (*(volatile unsigned int *)0xE0001000)
+#define DWT_CYCCNT (*(volatile unsigned int *)0xE0001004)
+#else
+#include <time.h>
+#endif
+
+//Sensor readings fed to the cases, so branches are taken as they would be in use
+#define BENCH_INPUTS 64
+static float benchInputs[BENCH_INPUTS];
+
+//Case state
+static DEMAFilter benchDEMA;
+static TUAFilter benchTUA;
+static vel_TBH benchTBH;
+static pos_PID benchPID;
+
+//Median windows timed, and the filter the current case steps
+#define BENCH_WINDOWS 4
+static const int benchWindows[BENCH_WINDOWS] = {3, 7, 11, 15};
+static const char *benchMedianNames[BENCH_WINDOWS] = {"median_3", "median_7", "median_11", "median_15"};
+static const char *benchHampelNames[BENCH_WINDOWS] = {"hampel_3", "hampel_7", "hampel_11", "hampel_15"};
+static MedianFilter benchMedian;
+static HampelFilter benchHampel;
+
+//Results are summed here so calls cannot be optimized away
+static volatile float benchSink;
+
+/**
+ * Enables the cycle counter (call once before benchmarking on the Cortex)
+ */
+void bench_Init()
+{
+#ifdef __arm__
+	DEMCR |= 1 << 24; //TRCENA
+	DWT_CYCCNT = 0;
+	DWT_CTRL |= 1;    //CYCCNTENA
+#endif
+}
+
+/**
+ * Gets the current tick count (cycles on the Cortex, ns on a host)
+ */
+unsigned int bench_Now()
+{
+#ifdef __arm__
+	return DWT_CYCCNT;
+#else
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+#endif
+}
+
+static void benchEmpty(const int i)
+{
+	benchSink = benchInputs[i];
+}
+
+static void benchDEMAStep(const int i)
+{
+	benchSink = filter_DEMA(&benchDEMA, benchInputs[i], 0.19, 0.0526);
+}
+
+static void benchTUAStep(const int i)
+{
+	benchSink = filter_TUA(&benchTUA, benchInputs[i]);
+}
+
+static void benchTBHStep(const int i)
+{
+	//Pretend a loop period has passed so the full step runs instead of the zero dt early return
+	benchTBH.prevTime = millis() - 20;
+	benchSink = vel_TBH_StepController(&benchTBH, benchInputs[i] * 4);
+}
+
+static void benchPIDStep(const int i)
+{
+	benchPID.prevTime = millis() - 20;
+	benchSink = pos_PID_StepController(&benchPID, benchInputs[i]);
+}
+
+static void benchMedianStep(const int i)
+{
+	//Scrambled order so inserts land all over the window, not always at the end
+	benchSink = filter_Median(&benchMedian, benchInputs[(i * 29) & (BENCH_INPUTS - 1)]);
+}
+
+static void benchHampelStep(const int i)
+{
+	benchSink = filter_Hampel(&benchHampel, benchInputs[(i * 29) & (BENCH_INPUTS - 1)]);
+}
+
+/**
+ * Times one case, giving per call costs with the loop and timer cost removed
+ */
+static void benchCase(benchResult *result, const char *name, void (*fn)(const int), const float overhead)
+{
+	float samples[BENCH_SAMPLES];
+
+	for (int s = 0; s < BENCH_SAMPLES; s++)
+	{
+		const unsigned int start = bench_Now();
+
+		for (int i = 0; i < BENCH_BATCH; i++)
+		{
+			fn((s * BENCH_BATCH + i) & (BENCH_INPUTS - 1));
+		}
+
+		const float perCall = (float)(bench_Now() - start) / BENCH_BATCH - overhead;
+		samples[s] = perCall > 0 ? perCall : 0;
+	}
+
+	//Insertion sort (few samples, mostly ordered after warmup)
+	for (int i = 1; i < BENCH_SAMPLES; i++)
+	{
+		const float v = samples[i];
+		int j = i - 1;
+
+		while (j >= 0 && samples[j] > v)
+		{
+			samples[j + 1] = samples[j];
+			j--;
+		}
+
+		samples[j + 1] = v;
+	}
+
+	result->name = name;
+	result->min = samples[0];
+	result->median = samples[BENCH_SAMPLES / 2];
+	result->p90 = samples[BENCH_SAMPLES * 9 / 10];
+	result->p99 = samples[BENCH_SAMPLES * 99 / 100];
+	result->baseline = 0;
+	result->regressed = false;
+}
+
+/**
+ * Times every case
+ *
+ * @param results Array of at least BENCH_CASES results to fill
+ * @return Number of cases run
+ */
+int bench_RunSuite(benchResult *results)
+{
+	//Flywheel-like position ramp with a little ripple
+	for (int i = 0; i < BENCH_INPUTS; i++)
+	{
+		benchInputs[i] = i * 37 + (i % 5) * 3 - (i % 3) * 2;
+	}
+
+	filter_Init_DEMA(&benchDEMA);
+	filter_Init_TUA(&benchTUA);
+	vel_TBH_InitController(&benchTBH, 0.01, 60, 392);
+	vel_TBH_SetTargetVelocity(&benchTBH, 2000, 60);
+	pos_PID_InitController(&benchPID, 0.5, 0.01, 0.2);
+	pos_PID_SetTargetPosition(&benchPID, 1000);
+
+	//Cost of the loop and timer alone
+	benchResult empty;
+	benchCase(&empty, "empty", benchEmpty, 0);
+
+	benchCase(&(results[0]), "filter_DEMA", benchDEMAStep, empty.median);
+	benchCase(&(results[1]), "filter_TUA", benchTUAStep, empty.median);
+	benchCase(&(results[2]), "vel_TBH_Step", benchTBHStep, empty.median);
+	benchCase(&(results[3]), "pos_PID_Step", benchPIDStep, empty.median);
+
+	for (int w = 0; w < BENCH_WINDOWS; w++)
+	{
+		filter_Init_Median(&benchMedian, benchWindows[w]);
+		filter_Init_Hampel(&benchHampel, benchWindows[w], 3);
+
+		benchCase(&(results[4 + w]), benchMedianNames[w], benchMedianStep, empty.median);
+		benchCase(&(results[4 + BENCH_WINDOWS + w]), benchHampelNames[w], benchHampelStep, empty.median);
+	}
+
+	return BENCH_CASES;
+}
+
+/**
+ * Writes results as a new baseline file
+ *
+ * @return Whether the whole file was written
+ */
+static bool benchWriteBaseline(const benchResult *results, const int count, const char *file)
+{
+	FILE *f = fopen(file, "w");
+
+	if (f == NULL)
+	{
+		return false;
+	}
+
+	const benchBaselineHeader header = {BENCH_BASELINE_MAGIC, BENCH_BASELINE_VERSION, count};
+	bool ok = fwrite(&header, sizeof(header), 1, f) == 1;
+
+	for (int i = 0; ok && i < count; i++)
+	{
+		benchBaselineEntry entry;
+
+		strncpy(entry.name, results[i].name, BENCH_NAME_LENGTH - 1);
+		entry.name[BENCH_NAME_LENGTH - 1] = '\0';
+		entry.median = results[i].median;
+
+		ok = fwrite(&entry, sizeof(entry), 1, f) == 1;
+	}
+
+	fclose(f);
+
+	return ok;
+}
+
+/**
+ * Checks results against a baseline file, writing the file if it does not exist
+ * Cases are matched by name; an existing baseline is only replaced when update is set
+ *
+ * @param results Results from bench_RunSuite
+ * @param count Number of results
+ * @param file Baseline file name
+ * @param update Overwrite the baseline with these results
+ * @param tolerance Allowed slowdown of a median (e.g. BENCH_TOLERANCE)
+ * @return Number of regressed cases, plus cases missing from the baseline and baseline cases no
+ * longer run (the regression gate fails if nonzero), or -1 if the baseline cannot be read
+ */
+int bench_Compare(benchResult *results, const int count, const char *file, const bool update, const float tolerance)
+{
+	for (int i = 0; i < count; i++)
+	{
+		results[i].baseline = 0;
+		results[i].regressed = false;
+		results[i].unmatched = true;
+	}
+
+	FILE *f = update ? NULL : fopen(file, "r");
+
+	//The first run (or an update) records the baseline
+	if (f == NULL)
+	{
+		for (int i = 0; i < count; i++)
+		{
+			results[i].unmatched = false;
+		}
+
+		return benchWriteBaseline(results, count, file) ? 0 : -1;
+	}
+
+	benchBaselineHeader header;
+
+	if (fread(&header, sizeof(header), 1, f) != 1 || header.magic != BENCH_BASELINE_MAGIC ||
+		header.version != BENCH_BASELINE_VERSION)
+	{
+		fclose(f);
+		return -1;
+	}
+
+	int failed = 0;
+
+	for (int e = 0; e < header.count; e++)
+	{
+		benchBaselineEntry entry;
+
+		if (fread(&entry, sizeof(entry), 1, f) != 1)
+		{
+			fclose(f);
+			return -1;
+		}
+
+		entry.name[BENCH_NAME_LENGTH - 1] = '\0';
+
+		int i = 0;
+
+		while (i < count && strncmp(results[i].name, entry.name, BENCH_NAME_LENGTH - 1) != 0)
+		{
+			i++;
+		}
+
+		//A case which was removed or renamed since the baseline was recorded
+		if (i == count)
+		{
+			failed++;
+			continue;
+		}
+
+		results[i].baseline = entry.median;
+		results[i].regressed = results[i].median > entry.median * (1 + tolerance);
+		results[i].unmatched = false;
+		failed += results[i].regressed;
+	}
+
+	fclose(f);
+
+	//Cases added since the baseline was recorded have nothing to be compared against
+	for (int i = 0; i < count; i++)
+	{
+		failed += results[i].unmatched;
+	}
+
+	return failed;
+}
+
+/**
+ * Prints a table of results
+ *
+ * @param port Where to print (stdout, uart1, or uart2)
+ * @param results Results from bench_RunSuite
+ * @param count Number of results
+ */
+void bench_Print(FILE *port, const benchResult *results, const int count)
+{
+	//Tenths of a tick, printed with integer formats
+	fprintf(port, "case              min   median      p90      p99 baseline\r\n");
+
+	for (int i = 0; i < count; i++)
+	{
+		const benchResult *r = &(results[i]);
+		const int values[5] = {r->min * 10, r->median * 10, r->p90 * 10, r->p99 * 10, r->baseline * 10};
+
+		fprintf(port, "%-12s", r->name);
+
+		for (int j = 0; j < 5; j++)
+		{
+			fprintf(port, " %6d.%d", values[j] / 10, values[j] % 10);
+		}
+
+		fprintf(port, r->regressed ? " REGRESSED\r\n" : r->unmatched ? " NO BASELINE\r\n" : "\r\n");
+	}
+}
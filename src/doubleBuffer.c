@@ -0,0 +1,75 @@
+#include <string.h>
+#include "API.h"
+#include "doubleBuffer.h"
+
+/**
+ * Gets the buffer readers are copying
+ * Only the writer may call this, and must not modify the buffer
+ *
+ * @param db The double buffer
+ */
+const void* doubleBuffer_GetFront(doubleBuffer *db)
+{
+	return (const char *)db->buffers + (db->flips & 1) * db->size;
+}
+
+/**
+ * Gets the buffer to fill before the next flip
+ * Only the writer may call this
+ *
+ * @param db The double buffer
+ */
+void* doubleBuffer_GetBack(doubleBuffer *db)
+{
+	return (char *)db->buffers + ((db->flips + 1) & 1) * db->size;
+}
+
+/**
+ * Makes the back buffer the front one
+ * Only the writer may call this, once the back buffer is complete
+ *
+ * @param db The double buffer
+ */
+void doubleBuffer_Flip(doubleBuffer *db)
+{
+	//The back buffer must be complete before any reader can see it as the front
+	__sync_synchronize();
+	db->flips++;
+}
+
+/**
+ * Copies a whole buffer into the back buffer and flips it to the front
+ * Only the writer may call this
+ *
+ * @param db The double buffer
+ * @param src Data to publish (one buffer's worth)
+ */
+void doubleBuffer_Write(doubleBuffer *db, const void *src)
+{
+	memcpy(doubleBuffer_GetBack(db), src, db->size);
+	doubleBuffer_Flip(db);
+}
+
+/**
+ * Copies part of the front buffer
+ * Lock-free and safe to call from any task
+ *
+ * @param db The double buffer
+ * @param out Destination
+ * @param offset Byte offset into the buffer
+ * @param size Bytes to copy
+ */
+void doubleBuffer_Read(doubleBuffer *db, void *out, const unsigned int offset, const unsigned int size)
+{
+	unsigned int flips;
+
+	//The front buffer is only rewritten after another flip, so retry if one happened during the copy
+	//Retries only happen when the writer flipped mid-copy, so a reader never waits for the writer to finish
+	do
+	{
+		flips = db->flips;
+		__sync_synchronize();
+		memcpy(out, (const char *)db->buffers + (flips & 1) * db->size + offset, size);
+		__sync_synchronize();
+	} while (flips != db->flips);
+}
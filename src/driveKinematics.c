@@ -0,0 +1,155 @@
+#include "API.h"
+#include "driveKinematics.h"
+#include "motorControl.h"
+
+/**
+ * Desaturates, stores, and sends a mix to the motor groups
+ */
+static void driveKinematicsWrite(driveKinematics *dk, int *powers)
+{
+	driveKinematics_Desaturate(powers, dk->count);
+
+	for (unsigned char i = 0; i < dk->count; i++)
+	{
+		dk->outputs[i] = powers[i];
+	}
+
+	//One batch, so the slew task never moves some wheels a tick before the others
+	setMotorGroupSpeeds(dk->groups, powers, dk->count);
+}
+
+/**
+ * Initializes a drive with a left and a right side
+ *
+ * @param dk The drive
+ * @param leftGroup Left side motor group
+ * @param rightGroup Right side motor group
+ */
+void driveKinematics_InitTank(driveKinematics *dk, const unsigned char leftGroup, const unsigned char rightGroup)
+{
+	dk->layout = DRIVE_LAYOUT_TANK;
+	dk->groups[0] = leftGroup;
+	dk->groups[1] = rightGroup;
+	dk->count = 2;
+
+	for (int i = 0; i < DRIVE_WHEELS_MAX; i++)
+	{
+		dk->outputs[i] = 0;
+	}
+}
+
+/**
+ * Initializes an X-drive or mecanum drive
+ * Wheels are mixed the same way; each group's scale should make positive power drive its wheel forward
+ *
+ * @param dk The drive
+ * @param frontLeft Front left motor group
+ * @param frontRight Front right motor group
+ * @param backLeft Back left motor group
+ * @param backRight Back right motor group
+ */
+void driveKinematics_InitHolonomic(driveKinematics *dk, const unsigned char frontLeft, const unsigned char frontRight, const unsigned char backLeft, const unsigned char backRight)
+{
+	dk->layout = DRIVE_LAYOUT_HOLONOMIC;
+	dk->groups[0] = frontLeft;
+	dk->groups[1] = frontRight;
+	dk->groups[2] = backLeft;
+	dk->groups[3] = backRight;
+	dk->count = 4;
+
+	for (int i = 0; i < DRIVE_WHEELS_MAX; i++)
+	{
+		dk->outputs[i] = 0;
+	}
+}
+
+/**
+ * Drives each side directly
+ *
+ * @param dk The drive
+ * @param left Left side power
+ * @param right Right side power
+ */
+void driveKinematics_Tank(driveKinematics *dk, const int left, const int right)
+{
+	int powers[DRIVE_WHEELS_MAX] = {left, right, left, right};
+	driveKinematicsWrite(dk, powers);
+}
+
+/**
+ * Drives from a forward and a turn command
+ * On a holonomic drive this is the same as driveKinematics_Holonomic with no strafe
+ *
+ * @param dk The drive
+ * @param forward Forward power
+ * @param turn Turn power (positive turns clockwise)
+ */
+void driveKinematics_Arcade(driveKinematics *dk, const int forward, const int turn)
+{
+	driveKinematics_Holonomic(dk, forward, 0, turn);
+}
+
+/**
+ * Drives a holonomic drive from forward, strafe, and turn commands
+ * On a tank drive, strafe is ignored
+ *
+ * @param dk The drive
+ * @param forward Forward power
+ * @param strafe Strafe power (positive strafes right)
+ * @param turn Turn power (positive turns clockwise)
+ */
+void driveKinematics_Holonomic(driveKinematics *dk, const int forward, const int strafe, const int turn)
+{
+	if (dk->layout == DRIVE_LAYOUT_TANK)
+	{
+		int powers[DRIVE_WHEELS_MAX] = {forward + turn, forward - turn};
+		driveKinematicsWrite(dk, powers);
+		return;
+	}
+
+	//Front left and back right rollers push diagonally one way, the other pair the other way
+	int powers[DRIVE_WHEELS_MAX] = {
+		forward + strafe + turn, //Front left
+		forward - strafe - turn, //Front right
+		forward - strafe + turn, //Back left
+		forward + strafe - turn  //Back right
+	};
+
+	driveKinematicsWrite(dk, powers);
+}
+
+/**
+ * Scales wheel powers down together so none exceeds MOTOR_MAX_VALUE, keeping their ratios
+ *
+ * @param powers Wheel powers
+ * @param count Number of wheels
+ */
+void driveKinematics_Desaturate(int *powers, const unsigned char count)
+{
+	int largest = 0;
+
+	for (unsigned char i = 0; i < count; i++)
+	{
+		largest = abs(powers[i]) > largest ? abs(powers[i]) : largest;
+	}
+
+	//Clipping each wheel on its own would change the ratios and so the direction of travel
+	if (largest > MOTOR_MAX_VALUE)
+	{
+		for (unsigned char i = 0; i < count; i++)
+		{
+			powers[i] = powers[i] * MOTOR_MAX_VALUE / largest;
+		}
+	}
+}
+
+/**
+ * Gets the output of one wheel from the last mix
+ *
+ * @param dk The drive
+ * @param wheel Wheel in layout order
+ */
+int driveKinematics_GetOutput(driveKinematics *dk, const unsigned char wheel)
+{
+	return dk->outputs[wheel];
+}
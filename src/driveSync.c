@@ -0,0 +1,147 @@
+#include "API.h"
+#include "driveSync.h"
+#include "motorControl.h"
+
+/**
+ * Initializes a synchronized drive controller
+ *
+ * @param ds The drive controller
+ * @param kP Distance proportional gain
+ * @param kI Distance integral gain
+ * @param kD Distance derivative gain
+ * @param kSync Cross-coupling gain
+ * @param leftGroup Left side motor group
+ * @param rightGroup Right side motor group
+ */
+void driveSync_InitController(driveSync *ds, const float kP, const float kI, const float kD, const float kSync, const unsigned char leftGroup, const unsigned char rightGroup)
+{
+	pos_PID_InitController(&(ds->distance), kP, kI, kD);
+
+	ds->kSync = kSync;
+	ds->source = DRIVE_SYNC_ENCODER;
+	ds->gyro = NULL;
+
+	ds->leftStart = 0;
+	ds->rightStart = 0;
+	ds->headingStart = 0;
+
+	ds->leftGroup = leftGroup;
+	ds->rightGroup = rightGroup;
+
+	ds->syncError = 0;
+
+	ds->leftOut = 0;
+	ds->rightOut = 0;
+}
+
+/**
+ * Sets the motor groups driven by the controller
+ *
+ * @param ds The drive controller
+ * @param leftGroup Left side motor group
+ * @param rightGroup Right side motor group
+ */
+void driveSync_SetMotorGroups(driveSync *ds, const unsigned char leftGroup, const unsigned char rightGroup)
+{
+	ds->leftGroup = leftGroup;
+	ds->rightGroup = rightGroup;
+}
+
+/**
+ * Synchronizes on gyro heading instead of encoder difference
+ *
+ * @param ds The drive controller
+ * @param gyro The gyro, or NULL to go back to encoder difference
+ */
+void driveSync_UseGyro(driveSync *ds, Gyro gyro)
+{
+	ds->gyro = gyro;
+	ds->source = gyro == NULL ? DRIVE_SYNC_ENCODER : DRIVE_SYNC_GYRO;
+}
+
+/**
+ * Sets a new distance to drive straight from the current position
+ *
+ * @param ds The drive controller
+ * @param target Distance to drive in encoder ticks
+ * @param leftSens Current left encoder reading
+ * @param rightSens Current right encoder reading
+ */
+void driveSync_SetTarget(driveSync *ds, const int target, const int leftSens, const int rightSens)
+{
+	ds->leftStart = leftSens;
+	ds->rightStart = rightSens;
+	ds->headingStart = ds->gyro == NULL ? 0 : gyroGet(ds->gyro);
+
+	pos_PID_SetTargetPosition(&(ds->distance), target);
+}
+
+/**
+ * Gets the current distance error
+ *
+ * @param ds The drive controller
+ */
+int driveSync_GetError(driveSync *ds)
+{
+	return pos_PID_GetError(&(ds->distance));
+}
+
+/**
+ * Gets the current sync error
+ *
+ * @param ds The drive controller
+ */
+int driveSync_GetSyncError(driveSync *ds)
+{
+	return ds->syncError;
+}
+
+/**
+ * Steps the controller's calculations and sets both motor groups
+ *
+ * @param ds The drive controller
+ * @param leftSens New left encoder reading
+ * @param rightSens New right encoder reading
+ * @return Common (distance) output
+ */
+int driveSync_StepController(driveSync *ds, const int leftSens, const int rightSens)
+{
+	const int leftTravel = leftSens - ds->leftStart;
+	const int rightTravel = rightSens - ds->rightStart;
+
+	//Drive the average of both sides to the target (the last output is kept if dt was zero)
+	pos_PID_StepController(&(ds->distance), (leftTravel + rightTravel) / 2);
+	const int common = pos_PID_GetOutput(&(ds->distance));
+
+	//Positive sync error means the left side is ahead
+	if (ds->source == DRIVE_SYNC_GYRO)
+	{
+		//Heading counts up turning counterclockwise, which is the right side getting ahead
+		ds->syncError = ds->headingStart - gyroGet(ds->gyro);
+	}
+	else
+	{
+		ds->syncError = leftTravel - rightTravel;
+	}
+
+	const int correction = ds->kSync * ds->syncError;
+	int left = common - correction;
+	int right = common + correction;
+
+	//Scale both sides down together so saturation does not undo the correction
+	const int largest = abs(left) > abs(right) ? abs(left) : abs(right);
+
+	if (largest > MOTOR_MAX_VALUE)
+	{
+		left = left * MOTOR_MAX_VALUE / largest;
+		right = right * MOTOR_MAX_VALUE / largest;
+	}
+
+	ds->leftOut = left;
+	ds->rightOut = right;
+
+	setMotorGroupSpeed(ds->leftGroup, left);
+	setMotorGroupSpeed(ds->rightGroup, right);
+
+	return common;
+}
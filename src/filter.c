@@ -127,3 +127,164 @@ float filter_TUA(TUAFilter *filter, const float componentIn)
 
 	return avg / 10.0;
 }
+
+/**
+ * Initializes a running median filter
+ *
+ * @param filter The median filter
+ * @param size Window size (odd, 3 to FILTER_MEDIAN_MAX)
+ */
+void filter_Init_Median(MedianFilter *filter, const int size)
+{
+	filter->size = size < 1 ? 1 : (size > FILTER_MEDIAN_MAX ? FILTER_MEDIAN_MAX : size);
+	filter->index = 0;
+	filter->count = 0;
+
+	for (int i = 0; i < FILTER_MEDIAN_MAX; i++)
+	{
+		filter->components[i] = 0;
+		filter->sorted[i] = 0;
+	}
+}
+
+/**
+ * Filters an input
+ *
+ * @param filter The median filter
+ * @param componentIn Input to filter
+ */
+float filter_Median(MedianFilter *filter, const float componentIn)
+{
+	int pos;
+
+	//Drop the oldest value from the sorted copy, leaving a gap at pos
+	if (filter->count == filter->size)
+	{
+		const float oldest = filter->components[filter->index];
+
+		pos = 0;
+		while (pos < filter->count - 1 && filter->sorted[pos] != oldest)
+		{
+			pos++;
+		}
+	}
+	else
+	{
+		pos = filter->count++;
+	}
+
+	//Slide the gap to where the new value belongs
+	while (pos > 0 && filter->sorted[pos - 1] > componentIn)
+	{
+		filter->sorted[pos] = filter->sorted[pos - 1];
+		pos--;
+	}
+
+	while (pos < filter->count - 1 && filter->sorted[pos + 1] < componentIn)
+	{
+		filter->sorted[pos] = filter->sorted[pos + 1];
+		pos++;
+	}
+
+	filter->sorted[pos] = componentIn;
+
+	filter->components[filter->index] = componentIn;
+	filter->index = filter->index + 1 >= filter->size ? 0 : filter->index + 1;
+
+	return filter->sorted[filter->count / 2];
+}
+
+/**
+ * Initializes a Hampel filter
+ *
+ * @param filter The Hampel filter
+ * @param size Window size (odd, 3 to FILTER_MEDIAN_MAX)
+ * @param threshold Outlier limit in standard deviations (3 is typical)
+ */
+void filter_Init_Hampel(HampelFilter *filter, const int size, const float threshold)
+{
+	filter_Init_Median(&(filter->median), size);
+	filter->threshold = threshold;
+	filter->outlier = false;
+}
+
+/**
+ * Filters an input, passing it through unless it is an outlier
+ *
+ * @param filter The Hampel filter
+ * @param componentIn Input to filter
+ */
+float filter_Hampel(HampelFilter *filter, const float componentIn)
+{
+	const float median = filter_Median(&(filter->median), componentIn);
+	const float *sorted = filter->median.sorted;
+	const int count = filter->median.count;
+
+	//Deviations from the median are ordered outward from it on both sides of the sorted window,
+	//so their median is found by merging the two sides instead of sorting
+	int below = count / 2, above = count / 2 + 1;
+	float mad = 0;
+
+	for (int i = 0; i <= count / 2; i++)
+	{
+		const float down = below >= 0 ? median - sorted[below] : -1;
+		const float up = above < count ? sorted[above] - median : -1;
+
+		if (up < 0 || (down >= 0 && down <= up))
+		{
+			mad = down;
+			below--;
+		}
+		else
+		{
+			mad = up;
+			above++;
+		}
+	}
+
+	const float deviation = componentIn - median;
+	filter->outlier = (deviation < 0 ? -deviation : deviation) > filter->threshold * FILTER_HAMPEL_MAD * mad;
+
+	return filter->outlier ? median : componentIn;
+}
+
+/**
+ * Initializes a rate of change gate
+ *
+ * @param filter The rate gate
+ * @param maxStep Largest accepted change per sample
+ * @param rejectLimit Consecutive rejections before a jump is accepted as real
+ */
+void filter_Init_RateGate(RateGateFilter *filter, const float maxStep, const int rejectLimit)
+{
+	filter->output = 0.0;
+	filter->maxStep = maxStep;
+	filter->rejectLimit = rejectLimit;
+	filter->rejected = 0;
+	filter->started = false;
+}
+
+/**
+ * Filters an input, holding the last output if it changed too quickly
+ *
+ * @param filter The rate gate
+ * @param componentIn Input to filter
+ */
+float filter_RateGate(RateGateFilter *filter, const float componentIn)
+{
+	const float step = componentIn - filter->output;
+
+	//A jump which persists is a real change, not a spike
+	if (!filter->started || (step <= filter->maxStep && step >= -filter->maxStep) || filter->rejected >= filter->rejectLimit)
+	{
+		filter->output = componentIn;
+		filter->rejected = 0;
+		filter->started = true;
+	}
+	else
+	{
+		filter->rejected++;
+	}
+
+	return filter->output;
+}
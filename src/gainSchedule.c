@@ -0,0 +1,169 @@
+#include "gainSchedule.h"
+
+/**
+ * Moves the cached segment to `segment` and precomputes its inverse span so interpolation
+ * needs no division
+ */
+static void gainSchedule_SetSegment(gainSchedule *gs, const unsigned char segment)
+{
+	const float span = gs->table[segment + 1].index - gs->table[segment].index;
+
+	gs->segment = segment;
+	gs->segmentInvSpan = span > 0 ? 1.0 / span : 0.0;
+}
+
+/**
+ * Copies the gains from a single row
+ */
+static void gainSchedule_SetFromRow(gainSchedule *gs, const gainScheduleEntry *row)
+{
+	gs->kP = row->kP;
+	gs->kI = row->kI;
+	gs->kD = row->kD;
+}
+
+/**
+ * Initializes a gain schedule
+ *
+ * @param gs The gain schedule
+ * @param table Rows of gains sorted by ascending index
+ * @param size Number of rows in `table` (at least one)
+ * @param source Variable the table is indexed by
+ */
+void gainSchedule_Init(gainSchedule *gs, const gainScheduleEntry *table, const unsigned char size, const gainScheduleSource source)
+{
+	gs->table = table;
+	gs->size = size;
+
+	gs->source = source;
+	gs->userValue = 0.0;
+
+	gs->segment = 0;
+	gs->segmentInvSpan = 0.0;
+
+	if (size > 1)
+	{
+		gainSchedule_SetSegment(gs, 0);
+	}
+
+	gainSchedule_SetFromRow(gs, &(table[0]));
+}
+
+/**
+ * Sets the lookup value used when the source is GAIN_SCHEDULE_USER
+ *
+ * @param gs The gain schedule
+ * @param value New lookup value (e.g. lift load or battery voltage)
+ */
+void gainSchedule_SetUserValue(gainSchedule *gs, const float value)
+{
+	gs->userValue = value;
+}
+
+/**
+ * Looks up and interpolates gains for a lookup value
+ * Constant time while the value stays in or next to the last segment, O(log n) otherwise
+ *
+ * @param gs The gain schedule
+ * @param index Lookup value
+ */
+void gainSchedule_Lookup(gainSchedule *gs, const float index)
+{
+	const gainScheduleEntry *table = gs->table;
+	const unsigned char last = gs->size - 1;
+
+	//Hold the end rows outside of the table
+	if (gs->size < 2 || index <= table[0].index)
+	{
+		gainSchedule_SetFromRow(gs, &(table[0]));
+		return;
+	}
+
+	if (index >= table[last].index)
+	{
+		gainSchedule_SetFromRow(gs, &(table[last]));
+		return;
+	}
+
+	unsigned char seg = gs->segment;
+
+	//Setpoints and measurements move slowly, so try the cached segment and its neighbors first
+	if (index < table[seg].index)
+	{
+		if (seg > 0 && index >= table[seg - 1].index)
+		{
+			gainSchedule_SetSegment(gs, seg - 1);
+		}
+		else
+		{
+			seg = 0xFF;
+		}
+	}
+	else if (index >= table[seg + 1].index)
+	{
+		if (seg + 2 <= last && index < table[seg + 2].index)
+		{
+			gainSchedule_SetSegment(gs, seg + 1);
+		}
+		else
+		{
+			seg = 0xFF;
+		}
+	}
+
+	//Binary search for the segment containing index
+	if (seg == 0xFF)
+	{
+		unsigned char low = 0, high = last;
+
+		while (high - low > 1)
+		{
+			const unsigned char mid = (low + high) >> 1;
+
+			if (index < table[mid].index)
+			{
+				high = mid;
+			}
+			else
+			{
+				low = mid;
+			}
+		}
+
+		gainSchedule_SetSegment(gs, low);
+	}
+
+	//Linearly interpolate between the rows bounding the segment
+	const gainScheduleEntry *a = &(table[gs->segment]);
+	const gainScheduleEntry *b = &(table[gs->segment + 1]);
+	const float t = (index - a->index) * gs->segmentInvSpan;
+
+	gs->kP = a->kP + (b->kP - a->kP) * t;
+	gs->kI = a->kI + (b->kI - a->kI) * t;
+	gs->kD = a->kD + (b->kD - a->kD) * t;
+}
+
+/**
+ * Looks up gains using the schedule's configured source
+ *
+ * @param gs The gain schedule
+ * @param setpoint Current controller target
+ * @param measured Current sensor reading
+ */
+void gainSchedule_Update(gainSchedule *gs, const float setpoint, const float measured)
+{
+	switch (gs->source)
+	{
+		case GAIN_SCHEDULE_SETPOINT:
+			gainSchedule_Lookup(gs, setpoint);
+			break;
+
+		case GAIN_SCHEDULE_MEASURED:
+			gainSchedule_Lookup(gs, measured);
+			break;
+
+		default:
+			gainSchedule_Lookup(gs, gs->userValue);
+			break;
+	}
+}
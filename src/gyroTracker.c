@@ -0,0 +1,194 @@
+#include "API.h"
+#include "gyroTracker.h"
+#include "math.h"
+
+/**
+ * Initializes a gyro tracker (call gyroTracker_Calibrate before use)
+ *
+ * @param gt The gyro tracker
+ * @param channel Analog channel of the gyro
+ */
+void gyroTracker_Init(gyroTracker *gt, const unsigned char channel)
+{
+	gt->channel = channel;
+	gt->scale = GYRO_TRACKER_SCALE;
+
+	gt->bias = analogRead(channel);
+	gt->noise = 0;
+
+	gt->left = NULL;
+	gt->right = NULL;
+	gt->prevLeft = 0;
+	gt->prevRight = 0;
+
+	gt->stillSince = micros();
+	gt->stationary = false;
+
+	gt->rate = 0;
+	gt->heading = 0;
+	gt->prevTime = micros();
+}
+
+/**
+ * Sets the gyro's scale
+ *
+ * @param gt The gyro tracker
+ * @param scale deg/s per ADC count (negative to flip direction)
+ */
+void gyroTracker_SetScale(gyroTracker *gt, const float scale)
+{
+	gt->scale = scale;
+}
+
+/**
+ * Sets the encoders used to detect a stationary robot, enabling bias tracking
+ *
+ * @param gt The gyro tracker
+ * @param left Left side quad encoder, or NULL to disable bias tracking
+ * @param right Right side quad encoder
+ */
+void gyroTracker_SetEncoders(gyroTracker *gt, Encoder left, Encoder right)
+{
+	gt->left = left;
+	gt->right = right;
+
+	if (left != NULL)
+	{
+		gt->prevLeft = encoderGet(left);
+		gt->prevRight = encoderGet(right);
+	}
+
+	gt->stillSince = micros();
+	gt->stationary = false;
+}
+
+/**
+ * Averages the gyro while the robot is still to find its bias
+ * Blocks for GYRO_TRACKER_CALIBRATION ms; the robot must not move
+ *
+ * @param gt The gyro tracker
+ */
+void gyroTracker_Calibrate(gyroTracker *gt)
+{
+	//Integer sums are exact; 1000 12-bit samples fit easily
+	int sum = 0;
+	long long sumSquares = 0;
+
+	for (int i = 0; i < GYRO_TRACKER_CALIBRATION; i++)
+	{
+		const int raw = analogRead(gt->channel);
+		sum += raw;
+		sumSquares += raw * raw;
+		delay(1);
+	}
+
+	gt->bias = (float)sum / GYRO_TRACKER_CALIBRATION;
+
+	const float variance = (float)sumSquares / GYRO_TRACKER_CALIBRATION - gt->bias * gt->bias;
+	gt->noise = variance > 0 ? sqrtf(variance) : 0;
+
+	gt->rate = 0;
+	gt->prevTime = micros();
+}
+
+/**
+ * Reads the gyro and integrates heading
+ * Cheap enough to call from the sensor sampling loop; call at a steady, fast rate (e.g. every 1 to 5ms)
+ *
+ * @param gt The gyro tracker
+ * @return Heading in degrees
+ */
+float gyroTracker_Step(gyroTracker *gt)
+{
+	const int raw = analogRead(gt->channel);
+	const unsigned long now = micros();
+	const unsigned int dt = now - gt->prevTime;
+	gt->prevTime = now;
+
+	if (dt == 0)
+	{
+		return gt->heading;
+	}
+
+	//Stationary once both sides have been stopped for a while
+	if (gt->left != NULL)
+	{
+		const int left = encoderGet(gt->left), right = encoderGet(gt->right);
+		const int limit = GYRO_TRACKER_STILL_SPEED * (int)dt / 1000000 + 1;
+		const bool still = abs(left - gt->prevLeft) < limit && abs(right - gt->prevRight) < limit;
+
+		gt->prevLeft = left;
+		gt->prevRight = right;
+
+		if (!still)
+		{
+			gt->stillSince = now;
+		}
+
+		gt->stationary = still && now - gt->stillSince >= GYRO_TRACKER_SETTLE * 1000;
+	}
+
+	//While stationary every reading is bias, so follow it and hold heading
+	if (gt->stationary)
+	{
+		gt->bias += GYRO_TRACKER_ALPHA * (raw - gt->bias);
+		gt->rate = 0;
+		return gt->heading;
+	}
+
+	gt->rate = (raw - gt->bias) * gt->scale;
+	gt->heading += gt->rate * dt * 1e-6f;
+
+	return gt->heading;
+}
+
+/**
+ * Sets the current heading
+ *
+ * @param gt The gyro tracker
+ * @param heading New heading in degrees
+ */
+void gyroTracker_SetHeading(gyroTracker *gt, const float heading)
+{
+	gt->heading = heading;
+}
+
+/**
+ * Gets the heading in degrees
+ *
+ * @param gt The gyro tracker
+ */
+float gyroTracker_GetHeading(gyroTracker *gt)
+{
+	return gt->heading;
+}
+
+/**
+ * Gets the rate of turn in deg/s
+ *
+ * @param gt The gyro tracker
+ */
+float gyroTracker_GetRate(gyroTracker *gt)
+{
+	return gt->rate;
+}
+
+/**
+ * Gets the current bias in ADC counts
+ *
+ * @param gt The gyro tracker
+ */
+float gyroTracker_GetBias(gyroTracker *gt)
+{
+	return gt->bias;
+}
+
+/**
+ * Gets whether the robot is stationary and the bias is being tracked
+ *
+ * @param gt The gyro tracker
+ */
+bool gyroTracker_IsStationary(gyroTracker *gt)
+{
+	return gt->stationary;
+}
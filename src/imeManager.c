@@ -0,0 +1,267 @@
+#include <string.h>
+#include "API.h"
+#include "doubleBuffer.h"
+#include "imeManager.h"
+
+//Managed IMEs (addresses 0 to imeDeviceCount - 1)
+static imeDevice imeDevices[IME_MANAGER_MAX];
+static unsigned int imeDeviceCount = 0;
+
+//Cached values handed to readers
+typedef struct imeCache_t
+{
+	int count;
+	float velocity;
+	unsigned long time;
+} imeCache;
+
+//Published caches: each batch writes the back buffer and then flips, readers copy the front one
+static imeCache imeCaches[2][IME_MANAGER_MAX];
+static doubleBuffer imePublished = DOUBLE_BUFFER(imeCaches);
+
+/**
+ * Initializes every IME on the chain and manages all of them
+ *
+ * @return Number of IMEs found
+ */
+unsigned int imeManager_Init()
+{
+	const unsigned int found = imeInitializeAll();
+	imeDeviceCount = found > IME_MANAGER_MAX ? IME_MANAGER_MAX : found;
+
+	for (unsigned char i = 0; i < imeDeviceCount; i++)
+	{
+		imeDevice *d = &(imeDevices[i]);
+
+		d->divider = IME_MANAGER_DIVIDER;
+		d->adapted = IME_MANAGER_DIVIDER;
+		d->countdown = i % IME_MANAGER_DIVIDER; //Spread slow IMEs over batches
+		d->readVelocity = false;
+
+		d->count = 0;
+		d->velocity = 0;
+		d->time = 0;
+
+		d->reads = 0;
+		d->errors = 0;
+		d->consecutiveErrors = 0;
+		d->latencyLast = 0;
+		d->latencyMax = 0;
+		d->latencyTotal = 0;
+	}
+
+	memset(imeCaches, 0, sizeof(imeCaches));
+
+	return found;
+}
+
+/**
+ * Sets how often an IME is polled
+ *
+ * @param address IME address
+ * @param divider Poll every divider batches (1 for critical IMEs such as a flywheel, which are never slowed down)
+ * @param readVelocity Also read the IME's own velocity instead of differentiating counts
+ */
+void imeManager_SetRate(const unsigned char address, const unsigned char divider, const bool readVelocity)
+{
+	imeDevice *d = &(imeDevices[address]);
+
+	d->divider = divider == 0 ? 1 : divider;
+	d->adapted = d->divider;
+	d->countdown = 0;
+	d->readVelocity = readVelocity;
+}
+
+/**
+ * Reads one IME into its cache, returning the bus time used
+ */
+static unsigned int imeRead(imeDevice *d, const unsigned char address)
+{
+	int count, velocity = 0;
+	const unsigned long start = micros();
+
+	bool ok = imeGet(address, &count);
+
+	if (ok && d->readVelocity)
+	{
+		ok = imeGetVelocity(address, &velocity);
+	}
+
+	const unsigned long now = micros();
+	const unsigned int latency = now - start;
+
+	d->reads++;
+	d->latencyLast = latency;
+	d->latencyMax = latency > d->latencyMax ? latency : d->latencyMax;
+	d->latencyTotal += latency;
+
+	if (!ok)
+	{
+		d->errors++;
+		d->consecutiveErrors++;
+		return latency;
+	}
+
+	//Differentiate counts unless the IME's own velocity was read
+	if (d->readVelocity)
+	{
+		d->velocity = velocity;
+	}
+	else if (d->time != 0 && now != d->time)
+	{
+		d->velocity = (count - d->count) * 1e6f / (unsigned int)(now - d->time);
+	}
+
+	d->count = count;
+	d->time = now;
+	d->consecutiveErrors = 0;
+
+	return latency;
+}
+
+/**
+ * Polls every IME which is due in one batch
+ * Called by the IME manager task; only call directly if the task is not running
+ */
+void imeManager_Poll()
+{
+	unsigned int busTime = 0;
+
+	for (unsigned char i = 0; i < imeDeviceCount; i++)
+	{
+		imeDevice *d = &(imeDevices[i]);
+
+		if (d->countdown > 0)
+		{
+			d->countdown--;
+			continue;
+		}
+
+		busTime += imeRead(d, i);
+
+		//Back off an IME which keeps failing so it stops eating bus time, and recover once it answers
+		if (d->consecutiveErrors >= IME_MANAGER_ERROR_LIMIT)
+		{
+			d->adapted = d->adapted * 2 > IME_MANAGER_MAX_DIVIDER ? IME_MANAGER_MAX_DIVIDER : d->adapted * 2;
+		}
+		else if (d->consecutiveErrors == 0 && d->adapted > d->divider && busTime < IME_MANAGER_BUDGET / 2)
+		{
+			d->adapted /= 2;
+			d->adapted = d->adapted < d->divider ? d->divider : d->adapted;
+		}
+
+		d->countdown = d->adapted - 1;
+	}
+
+	//Over budget: slow every non-critical IME down
+	if (busTime > IME_MANAGER_BUDGET)
+	{
+		for (unsigned char i = 0; i < imeDeviceCount; i++)
+		{
+			imeDevice *d = &(imeDevices[i]);
+
+			if (d->divider > 1 && d->adapted < IME_MANAGER_MAX_DIVIDER)
+			{
+				d->adapted *= 2;
+			}
+		}
+	}
+
+	//Publish once the bus transactions are done, so readers never wait on the I2C chain
+	imeCache *back = doubleBuffer_GetBack(&imePublished);
+
+	for (unsigned char i = 0; i < imeDeviceCount; i++)
+	{
+		back[i].count = imeDevices[i].count;
+		back[i].velocity = imeDevices[i].velocity;
+		back[i].time = imeDevices[i].time;
+	}
+
+	doubleBuffer_Flip(&imePublished);
+}
+
+/**
+ * Gets the cached state of an IME
+ *
+ * @param address IME address
+ * @param out Reading to fill
+ */
+void imeManager_Get(const unsigned char address, imeReading *out)
+{
+	imeCache cache;
+	doubleBuffer_Read(&imePublished, &cache, address * sizeof(imeCache), sizeof(imeCache));
+
+	out->count = cache.count;
+	out->velocity = cache.velocity;
+	out->valid = cache.time != 0;
+	out->age = micros() - cache.time;
+}
+
+/**
+ * Gets the cached count of an IME
+ *
+ * @param address IME address
+ */
+int imeManager_GetCount(const unsigned char address)
+{
+	imeReading r;
+	imeManager_Get(address, &r);
+	return r.count;
+}
+
+/**
+ * Gets the cached velocity of an IME
+ *
+ * @param address IME address
+ */
+float imeManager_GetVelocity(const unsigned char address)
+{
+	imeReading r;
+	imeManager_Get(address, &r);
+	return r.velocity;
+}
+
+/**
+ * Gets an IME's state and statistics
+ *
+ * @param address IME address
+ */
+const imeDevice* imeManager_GetDevice(const unsigned char address)
+{
+	return &(imeDevices[address]);
+}
+
+/**
+ * Gets the number of managed IMEs
+ */
+unsigned int imeManager_GetDeviceCount()
+{
+	return imeDeviceCount;
+}
+
+/**
+ * Prints read latency and error counters of every IME
+ *
+ * @param port Where to print (stdout, uart1, or uart2)
+ */
+void imeManager_Print(FILE *port)
+{
+	fprintf(port, "ime  rate  reads  errors  last us  avg us  max us  age ms\r\n");
+
+	for (unsigned char i = 0; i < imeDeviceCount; i++)
+	{
+		const imeDevice *d = &(imeDevices[i]);
+		const unsigned int average = d->reads == 0 ? 0 : d->latencyTotal / d->reads;
+
+		fprintf(port, "%3u  %2u/%-2u %6u %7u %8u %7u %7u %7lu\r\n", i, d->adapted, d->divider, d->reads, d->errors,
+			d->latencyLast, average, d->latencyMax, d->time == 0 ? 0 : (micros() - d->time) / 1000);
+	}
+}
+
+/*
+ * Starts the IME manager task
+ */
+void startIMEManagerTask()
+{
+	taskRunLoop(imeManager_Poll, IME_MANAGER_PERIOD);
+}
@@ -0,0 +1,290 @@
+#include "API.h"
+#include "joystick.h"
+
+//Shaping of every axis, indexed by joystick - 1 and axis - 1
+static joystickAxis joystickAxes[JOYSTICK_NUM][JOYSTICK_AXES];
+
+//Latest sample
+static joystickSnapshot joystickState;
+
+//Whether the snapshot is being fed by joystick_Replay instead of the joysticks
+static volatile bool joystickReplaying = false;
+
+//Buttons read in each sample (groups 5 and 6 only have up and down)
+static const unsigned char joystickButtonGroups[12] = {5, 5, 6, 6, 7, 7, 7, 7, 8, 8, 8, 8};
+static const unsigned char joystickButtons[12] = {JOY_DOWN, JOY_UP, JOY_DOWN, JOY_UP,
+	JOY_DOWN, JOY_LEFT, JOY_UP, JOY_RIGHT, JOY_DOWN, JOY_LEFT, JOY_UP, JOY_RIGHT};
+
+/**
+ * Bakes an axis' calibration, deadband, and curve into its table
+ * Float math is fine here, it only runs when settings change
+ */
+static void joystickBuildTable(joystickAxis *a)
+{
+	const float deadband = (float)a->deadband / JOYSTICK_MAX_VALUE;
+
+	for (int reading = -128; reading < 128; reading++)
+	{
+		//Calibrate into -1 to 1
+		const int offset = reading - a->center;
+		const int range = offset > 0 ? a->max - a->center : a->center - a->min;
+		float x = range > 0 ? (float)offset / range : 0;
+		x = x > 1 ? 1 : (x < -1 ? -1 : x);
+
+		//Remove the deadband and stretch the rest so output starts from 0 at its edge
+		const float magnitude = x < 0 ? -x : x;
+		float y = magnitude <= deadband ? 0 : (magnitude - deadband) / (1 - deadband);
+
+		switch (a->curve)
+		{
+			case JOYSTICK_CURVE_LINEAR:
+				break;
+
+			case JOYSTICK_CURVE_EXPO:
+				y = (1 - a->expo) * y + a->expo * y * y * y;
+				break;
+
+			case JOYSTICK_CURVE_CUBIC:
+				y = y * y * y;
+				break;
+		}
+
+		const int out = (int)(y * JOYSTICK_MAX_VALUE + 0.5);
+		a->table[reading + 128] = x < 0 ? -out : out;
+	}
+}
+
+/**
+ * Initializes every axis to a linear curve with JOYSTICK_DEADBAND and no slew
+ */
+void joystick_Init()
+{
+	for (int j = 0; j < JOYSTICK_NUM; j++)
+	{
+		for (int i = 0; i < JOYSTICK_AXES; i++)
+		{
+			joystickAxis *a = &(joystickAxes[j][i]);
+			a->slew = 0;
+			a->output = 0;
+			a->curve = JOYSTICK_CURVE_LINEAR;
+			a->expo = 0;
+			a->deadband = JOYSTICK_DEADBAND;
+			a->center = 0;
+			a->min = -JOYSTICK_MAX_VALUE;
+			a->max = JOYSTICK_MAX_VALUE;
+			joystickBuildTable(a);
+
+			joystickState.axes[j][i] = 0;
+		}
+
+		joystickState.buttons[j] = 0;
+		joystickState.pressed[j] = 0;
+	}
+
+	joystickState.time = 0;
+}
+
+/**
+ * Sets the response curve of an axis and rebuilds its table
+ *
+ * @param joystick Joystick (1 or 2)
+ * @param axis Axis (1 to 4)
+ * @param curve Response curve
+ * @param expo Cubic fraction for JOYSTICK_CURVE_EXPO (0 to 1)
+ * @param deadband Readings within this many counts of center give 0
+ */
+void joystick_SetCurve(const unsigned char joystick, const unsigned char axis, const joystickCurve curve, const float expo, const int deadband)
+{
+	joystickAxis *a = &(joystickAxes[joystick - 1][axis - 1]);
+	a->curve = curve;
+	a->expo = expo < 0 ? 0 : (expo > 1 ? 1 : expo);
+	a->deadband = deadband < 0 ? 0 : (deadband >= JOYSTICK_MAX_VALUE ? JOYSTICK_MAX_VALUE - 1 : deadband);
+	joystickBuildTable(a);
+}
+
+/**
+ * Sets the calibration of an axis and rebuilds its table
+ *
+ * @param joystick Joystick (1 or 2)
+ * @param axis Axis (1 to 4)
+ * @param center Reading at rest
+ * @param min Reading at full negative deflection
+ * @param max Reading at full positive deflection
+ */
+void joystick_SetCalibration(const unsigned char joystick, const unsigned char axis, const int center, const int min, const int max)
+{
+	joystickAxis *a = &(joystickAxes[joystick - 1][axis - 1]);
+	a->center = center;
+	a->min = min;
+	a->max = max;
+	joystickBuildTable(a);
+}
+
+/**
+ * Takes the current reading of every axis as its center (the sticks must be at rest)
+ */
+void joystick_CalibrateCenters()
+{
+	for (int j = 0; j < JOYSTICK_NUM; j++)
+	{
+		for (int i = 0; i < JOYSTICK_AXES; i++)
+		{
+			joystickAxis *a = &(joystickAxes[j][i]);
+			a->center = joystickGetAnalog(j + 1, i + 1);
+			joystickBuildTable(a);
+		}
+	}
+}
+
+/**
+ * Sets the slew rate of an axis
+ *
+ * @param joystick Joystick (1 or 2)
+ * @param axis Axis (1 to 4)
+ * @param slew Largest output change per sample (0 for none)
+ */
+void joystick_SetSlew(const unsigned char joystick, const unsigned char axis, const int slew)
+{
+	joystickAxes[joystick - 1][axis - 1].slew = slew;
+}
+
+/**
+ * Reads both joysticks and shapes every axis into the snapshot
+ * Call once per driver control tick, then read the snapshot as often as needed
+ */
+void joystick_Sample()
+{
+	if (joystickReplaying)
+	{
+		return;
+	}
+
+	for (int j = 0; j < JOYSTICK_NUM; j++)
+	{
+		for (int i = 0; i < JOYSTICK_AXES; i++)
+		{
+			joystickAxis *a = &(joystickAxes[j][i]);
+
+			//One lookup replaces calibration, deadband, and curve math
+			const int target = a->table[(joystickGetAnalog(j + 1, i + 1) + 128) & 0xFF];
+			const int change = target - a->output;
+
+			if (a->slew > 0 && (change > a->slew || change < -a->slew))
+			{
+				a->output += change > 0 ? a->slew : -a->slew;
+			}
+			else
+			{
+				a->output = target;
+			}
+
+			joystickState.axes[j][i] = a->output;
+		}
+
+		unsigned short buttons = 0;
+
+		for (int b = 0; b < 12; b++)
+		{
+			if (joystickGetDigital(j + 1, joystickButtonGroups[b], joystickButtons[b]))
+			{
+				buttons |= joystickButtonBit(joystickButtonGroups[b], joystickButtons[b]);
+			}
+		}
+
+		joystickState.pressed[j] = buttons & ~joystickState.buttons[j];
+		joystickState.buttons[j] = buttons;
+	}
+
+	joystickState.time = millis();
+}
+
+/**
+ * Replaces the snapshot with recorded values (e.g. from autonomous playback)
+ * joystick_Sample leaves the snapshot alone until joystick_EndReplay
+ *
+ * @param axes Shaped outputs, JOYSTICK_AXES per joystick
+ * @param buttons Held buttons of each joystick (see joystickButtonBit)
+ */
+void joystick_Replay(const int *axes, const unsigned short *buttons)
+{
+	joystickReplaying = true;
+
+	for (int j = 0; j < JOYSTICK_NUM; j++)
+	{
+		for (int i = 0; i < JOYSTICK_AXES; i++)
+		{
+			joystickState.axes[j][i] = axes[j * JOYSTICK_AXES + i];
+		}
+
+		joystickState.pressed[j] = buttons[j] & ~joystickState.buttons[j];
+		joystickState.buttons[j] = buttons[j];
+	}
+
+	joystickState.time = millis();
+}
+
+/**
+ * Returns the snapshot to the joysticks, zeroing it until the next joystick_Sample
+ */
+void joystick_EndReplay()
+{
+	const int axes[JOYSTICK_NUM * JOYSTICK_AXES] = {0};
+	const unsigned short buttons[JOYSTICK_NUM] = {0};
+
+	joystick_Replay(axes, buttons);
+	joystickReplaying = false;
+}
+
+/**
+ * Gets the snapshot taken by the last joystick_Sample
+ */
+const joystickSnapshot* joystick_GetSnapshot()
+{
+	return &joystickState;
+}
+
+/**
+ * Gets the shaped output of an axis from the snapshot
+ *
+ * @param joystick Joystick (1 or 2)
+ * @param axis Axis (1 to 4)
+ */
+int joystick_GetAxis(const unsigned char joystick, const unsigned char axis)
+{
+	return joystickState.axes[joystick - 1][axis - 1];
+}
+
+/**
+ * Gets whether a button is held in the snapshot
+ *
+ * @param joystick Joystick (1 or 2)
+ * @param group Button group (5 to 8)
+ * @param button JOY_DOWN, JOY_LEFT, JOY_UP, or JOY_RIGHT
+ */
+bool joystick_GetButton(const unsigned char joystick, const unsigned char group, const unsigned char button)
+{
+	return (joystickState.buttons[joystick - 1] & joystickButtonBit(group, button)) != 0;
+}
+
+/**
+ * Gets whether a button went down in the snapshot
+ *
+ * @param joystick Joystick (1 or 2)
+ * @param group Button group (5 to 8)
+ * @param button JOY_DOWN, JOY_LEFT, JOY_UP, or JOY_RIGHT
+ */
+bool joystick_GetPressed(const unsigned char joystick, const unsigned char group, const unsigned char button)
+{
+	return (joystickState.pressed[joystick - 1] & joystickButtonBit(group, button)) != 0;
+}
+
+/**
+ * Gets the shaping of an axis
+ *
+ * @param joystick Joystick (1 or 2)
+ * @param axis Axis (1 to 4)
+ */
+joystickAxis* joystick_GetAxisShaping(const unsigned char joystick, const unsigned char axis)
+{
+	return &(joystickAxes[joystick - 1][axis - 1]);
+}
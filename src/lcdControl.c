@@ -5,6 +5,7 @@
 #include "lcdControl.h"
 #include "util.h"
 #include "timer.h"
+#include "profiler.h"
 
 //LCD thread wait time in ms
 static unsigned long lcdThreadWaitTime = 100;
@@ -16,6 +17,9 @@ menu *currentMenu = NULL;
 static unsigned int backlightBlinkRate = 0;
 static bool lcdCurrentBacklight = true;
 
+//Profiler site for the LCD thread (includes time spent in menu functions)
+static int lcdProfileSite = -1;
+
 /**
  * Allocates and initializes a menu
  *
@@ -217,6 +221,8 @@ static void updateLCDThread()
 
 	while (true)
 	{
+		PROFILE_BEGIN(lcdProfileSite);
+
 		//Blink LCD backlight at set rate (in Hz)
 		if (backlightBlinkRate == 0)
 		{
@@ -289,6 +295,8 @@ static void updateLCDThread()
 		lcdPrint(uart1, 1, currentMenu->msg);
 		lcdPrint(uart1, 2, SUBMENU_SELECT);
 
+		PROFILE_END(lcdProfileSite);
+
 		//Slow loop time to minimize impact on other threads
 		//Lower loop time for more responsive controls
 		delay(lcdThreadWaitTime);
@@ -303,5 +311,6 @@ static void updateLCDThread()
  */
 void startUpdateLCDThread()
 {
+	PROFILE_REGISTER(lcdProfileSite, "lcd");
 	taskCreate(updateLCDThread, TASK_DEFAULT_STACK_SIZE, NULL, TASK_PRIORITY_DEFAULT);
 }
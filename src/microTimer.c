@@ -0,0 +1,189 @@
+#include "API.h"
+#include "microTimer.h"
+
+//Clock shared by every timer
+static unsigned long (*microClock)() = micros;
+
+/**
+ * Gets the time from a mark to now
+ * Unsigned 32-bit subtraction is exact across one wrap of the Cortex's 32-bit micros()
+ */
+static unsigned long microTimerSince(const unsigned long now, const unsigned long mark)
+{
+	return (unsigned int)(now - mark);
+}
+
+/**
+ * Brings the running time up to now
+ */
+static void microTimerAccumulate(microTimer *mt, const unsigned long now)
+{
+	if (mt->running)
+	{
+		mt->elapsed += microTimerSince(now, mt->elapsedMark);
+	}
+
+	mt->elapsedMark = now;
+}
+
+/**
+ * Sets the clock used by every microsecond timer
+ * Lets host tests drive timers from a simulated clock
+ *
+ * @param clock Function returning microseconds, or NULL for micros()
+ */
+void microTimer_SetClock(unsigned long (*clock)())
+{
+	microClock = clock == NULL ? micros : clock;
+}
+
+/**
+ * Initializes a microsecond timer and starts it running
+ *
+ * @param mt The timer
+ */
+void microTimer_Init(microTimer *mt)
+{
+	const unsigned long now = microClock();
+
+	mt->dtMark = now;
+	mt->lapMark = now;
+	mt->elapsedMark = now;
+	mt->elapsed = 0;
+	mt->running = true;
+	mt->lapCount = 0;
+	mt->lapMin = 0;
+	mt->lapMax = 0;
+	mt->lapTotal = 0;
+}
+
+/**
+ * Gets the time in us since the last call of this function
+ * Independent of microTimer_Lap, so the two can be used on the same timer
+ *
+ * @param mt The timer
+ */
+unsigned long microTimer_GetDT(microTimer *mt)
+{
+	const unsigned long now = microClock();
+	const unsigned long dt = microTimerSince(now, mt->dtMark);
+
+	mt->dtMark = now;
+	microTimerAccumulate(mt, now);
+
+	return dt;
+}
+
+/**
+ * Gets the time in us since the last lap and adds it to the lap statistics
+ *
+ * @param mt The timer
+ */
+unsigned long microTimer_Lap(microTimer *mt)
+{
+	const unsigned long now = microClock();
+	const unsigned long lap = microTimerSince(now, mt->lapMark);
+
+	mt->lapMark = now;
+	microTimerAccumulate(mt, now);
+
+	mt->lapMin = mt->lapCount == 0 || lap < mt->lapMin ? lap : mt->lapMin;
+	mt->lapMax = lap > mt->lapMax ? lap : mt->lapMax;
+	mt->lapTotal += lap;
+	mt->lapCount++;
+
+	return lap;
+}
+
+/**
+ * Gets the total running time in us
+ * Stays correct across micros() wrapping as long as the timer is read at least once an hour
+ *
+ * @param mt The timer
+ */
+unsigned long long microTimer_GetElapsed(microTimer *mt)
+{
+	microTimerAccumulate(mt, microClock());
+	return mt->elapsed;
+}
+
+/**
+ * Pauses accumulation of running time
+ *
+ * @param mt The timer
+ */
+void microTimer_Stop(microTimer *mt)
+{
+	microTimerAccumulate(mt, microClock());
+	mt->running = false;
+}
+
+/**
+ * Resumes accumulation of running time
+ *
+ * @param mt The timer
+ */
+void microTimer_Start(microTimer *mt)
+{
+	//Time spent stopped is skipped by moving the mark without accumulating
+	microTimerAccumulate(mt, microClock());
+	mt->running = true;
+}
+
+/**
+ * Clears the running time and lap statistics and starts a new lap
+ *
+ * @param mt The timer
+ */
+void microTimer_Reset(microTimer *mt)
+{
+	const unsigned long now = microClock();
+
+	mt->lapMark = now;
+	mt->elapsedMark = now;
+	mt->elapsed = 0;
+	mt->lapCount = 0;
+	mt->lapMin = 0;
+	mt->lapMax = 0;
+	mt->lapTotal = 0;
+}
+
+/**
+ * Gets the number of laps recorded
+ *
+ * @param mt The timer
+ */
+unsigned int microTimer_GetLapCount(microTimer *mt)
+{
+	return mt->lapCount;
+}
+
+/**
+ * Gets the shortest lap in us (0 if there are none)
+ *
+ * @param mt The timer
+ */
+unsigned long microTimer_GetLapMin(microTimer *mt)
+{
+	return mt->lapMin;
+}
+
+/**
+ * Gets the longest lap in us
+ *
+ * @param mt The timer
+ */
+unsigned long microTimer_GetLapMax(microTimer *mt)
+{
+	return mt->lapMax;
+}
+
+/**
+ * Gets the mean lap in us
+ *
+ * @param mt The timer
+ */
+float microTimer_GetLapMean(microTimer *mt)
+{
+	return mt->lapCount == 0 ? 0 : (float)mt->lapTotal / mt->lapCount;
+}
@@ -1,17 +1,164 @@
 #include "API.h"
 #include "motorControl.h"
-#include "timer.h"
+#include "filter.h"
+#include "profiler.h"
 
 //Array for motors
 static driveMotor driveMotors[MOTOR_NUM];
 
+//Array for motor groups
+static motorGroup motorGroups[MOTOR_GROUP_NUM];
+
+//Guards group requested speeds while a batch is set or the slew rate task reads them
+static Mutex motorGroupMutex = NULL;
+
+//Profiler site for the slew rate task
+static int motorProfileSite = -1;
+
+/*
+ * Linearization for 393 motors, indexed by power + 128
+ * Inverts a model of free speed vs power with a deadband of 10 and saturation toward 127:
+ * speed = tanh((power - 10) / 55) / tanh(117 / 55)
+ */
+const signed char motorLinearization393[256] = {
+	-127, -127, -120, -115, -110, -106, -103, -100,  -97,  -94,  -92,  -90,  -88,  -86,  -84,  -82,
+	 -81,  -79,  -78,  -76,  -75,  -73,  -72,  -71,  -70,  -69,  -68,  -67,  -65,  -64,  -64,  -63,
+	 -62,  -61,  -60,  -59,  -58,  -57,  -57,  -56,  -55,  -54,  -53,  -53,  -52,  -51,  -51,  -50,
+	 -49,  -49,  -48,  -47,  -47,  -46,  -45,  -45,  -44,  -43,  -43,  -42,  -42,  -41,  -41,  -40,
+	 -39,  -39,  -38,  -38,  -37,  -37,  -36,  -36,  -35,  -35,  -34,  -34,  -33,  -33,  -32,  -32,
+	 -31,  -31,  -30,  -30,  -29,  -29,  -28,  -28,  -27,  -27,  -26,  -26,  -26,  -25,  -25,  -24,
+	 -24,  -23,  -23,  -22,  -22,  -22,  -21,  -21,  -20,  -20,  -19,  -19,  -18,  -18,  -18,  -17,
+	 -17,  -16,  -16,  -15,  -15,  -15,  -14,  -14,  -13,  -13,  -13,  -12,  -12,  -11,  -11,  -10,
+	   0,   10,   11,   11,   12,   12,   13,   13,   13,   14,   14,   15,   15,   15,   16,   16,
+	  17,   17,   18,   18,   18,   19,   19,   20,   20,   21,   21,   22,   22,   22,   23,   23,
+	  24,   24,   25,   25,   26,   26,   26,   27,   27,   28,   28,   29,   29,   30,   30,   31,
+	  31,   32,   32,   33,   33,   34,   34,   35,   35,   36,   36,   37,   37,   38,   38,   39,
+	  39,   40,   41,   41,   42,   42,   43,   43,   44,   45,   45,   46,   47,   47,   48,   49,
+	  49,   50,   51,   51,   52,   53,   53,   54,   55,   56,   57,   57,   58,   59,   60,   61,
+	  62,   63,   64,   64,   65,   67,   68,   69,   70,   71,   72,   73,   75,   76,   78,   79,
+	  81,   82,   84,   86,   88,   90,   92,   94,   97,  100,  103,  106,  110,  115,  120,  127
+};
+
+//Battery compensation
+static bool batteryCompensation = false;
+static float batteryNominal = MOTOR_BATTERY_NOMINAL;
+static float batteryScale = 1.0;
+static EMAFilter batteryFilter;
+static bool batteryFilterPrimed = false;
+
+//Thermal capping
+static bool thermalCapping = false;
+
+/**
+ * Sends a power to a motor port, applying output compensation
+ *
+ * @param index Port number of the motor
+ * @param power Commanded power
+ */
+static void motorOutput(const unsigned char index, float power)
+{
+	power *= batteryScale * (1.0 - driveMotors[index].thermalCut);
+
+	//Bound speed
+	power = power > MOTOR_MAX_VALUE ? MOTOR_MAX_VALUE : power;
+	power = power < MOTOR_MIN_VALUE ? MOTOR_MIN_VALUE : power;
+
+	//Linearize the motor's response
+	const signed char *table = driveMotors[index].linearization;
+	const int out = table == NULL ? (int)power : table[(int)power + 128];
+
+	driveMotors[index].lastOutput = out;
+	motorSet(index, out);
+}
+
+/**
+ * Steps the thermal model of every motor
+ *
+ * @param dt Time since the last step in seconds
+ * @return Whether any motor's power cap changed
+ */
+static bool motorStepThermal(const float dt)
+{
+	//Voltage across a motor at full power, relative to the voltage the model is given at
+	const float voltage = batteryFilter.output > MOTOR_BATTERY_MIN ? batteryFilter.output / MOTOR_THERMAL_VOLTAGE : 1.0;
+	const float decay = dt / MOTOR_THERMAL_TAU;
+	const float tripHeat = MOTOR_THERMAL_TRIP * MOTOR_THERMAL_TRIP;
+	bool changed = false;
+
+	for (unsigned char i = 0; i < MOTOR_NUM; i++)
+	{
+		driveMotor *m = &(driveMotors[i]);
+
+		if (m->freeSpeed <= 0)
+		{
+			continue;
+		}
+
+		//Current follows the difference between applied voltage and back EMF
+		const float applied = m->lastOutput * voltage / MOTOR_MAX_VALUE;
+		const float backEMF = m->velocity / m->freeSpeed;
+		m->current = MOTOR_THERMAL_STALL * (applied - backEMF);
+
+		//The PTC heats with current squared and cools toward ambient
+		m->heat += (m->current * m->current - m->heat) * decay;
+
+		//Scale power down as the trip point gets close
+		const float margin = 1.0 - m->heat / tripHeat;
+		float cut = 0.0;
+
+		if (thermalCapping && margin < MOTOR_THERMAL_CAP_START)
+		{
+			cut = 1.0 - margin / MOTOR_THERMAL_CAP_START;
+			cut = cut > 1.0 - MOTOR_THERMAL_CAP_MIN ? 1.0 - MOTOR_THERMAL_CAP_MIN : cut;
+		}
+
+		if (cut != m->thermalCut)
+		{
+			m->thermalCut = cut;
+			changed = true;
+		}
+	}
+
+	return changed;
+}
+
+/**
+ * Samples and smooths the battery voltage and updates the compensation scale
+ *
+ * @return Whether the scale changed
+ */
+static bool motorSampleBattery()
+{
+	const unsigned int mv = powerLevelMain();
+
+	//Ignore readings when not on a real battery
+	if (mv < MOTOR_BATTERY_MIN)
+	{
+		return false;
+	}
+
+	//Start the filter at the first reading instead of ramping up from zero
+	if (!batteryFilterPrimed)
+	{
+		batteryFilter.output_old = mv;
+		batteryFilterPrimed = true;
+	}
+
+	const float voltage = filter_EMA(&batteryFilter, mv, MOTOR_BATTERY_ALPHA);
+	float scale = batteryCompensation ? batteryNominal / voltage : 1.0;
+	scale = scale > MOTOR_BATTERY_MAX_SCALE ? MOTOR_BATTERY_MAX_SCALE : scale;
+
+	const bool changed = scale != batteryScale;
+	batteryScale = scale;
+
+	return changed;
+}
+
 /*
  * Sets the speed of the motor at index `index` to power `power`
  */
 void setMotorSpeed(const unsigned char index, const int power)
 {
-	timer t;
-	timer_GetDTFromStart(&t);
 	driveMotors[index].reqSpeed = power;
 }
 
@@ -59,27 +206,231 @@ void setMotorActive(const unsigned char index)
 
 /*
  * Sets the motor at index `index` to inactive
+ * Neither the slew rate controller nor the motor's group will update it
  */
 void setMotorInactive(const unsigned char index)
 {
 	driveMotors[index].active = false;
 }
 
+/**
+ * Enables or disables battery voltage compensation of motor outputs
+ * When enabled, every output (slewed, grouped, and raw) is scaled by nominal / battery voltage
+ *
+ * @param enabled Whether to compensate
+ * @param nominal Voltage (mV) that commanded powers correspond to, e.g. MOTOR_BATTERY_NOMINAL
+ */
+void setMotorBatteryCompensation(const bool enabled, const unsigned int nominal)
+{
+	batteryCompensation = enabled;
+	batteryNominal = nominal;
+
+	if (!enabled)
+	{
+		batteryScale = 1.0;
+	}
+}
+
+/*
+ * Gets the smoothed main battery voltage (mV) used for compensation
+ */
+float getMotorBatteryVoltage()
+{
+	return batteryFilter.output;
+}
+
+/**
+ * Sets the output linearization table of a motor
+ * Applied last, after slewing and battery compensation, so controllers see a linear plant
+ *
+ * @param index Port number of the motor
+ * @param table 256 entry lookup table indexed by power + 128 (e.g. motorLinearization393),
+ * or NULL to send powers unchanged
+ */
+void setMotorLinearization(const unsigned char index, const signed char *table)
+{
+	driveMotors[index].linearization = table;
+}
+
+/**
+ * Builds one direction of a linearization table from measured speeds
+ *
+ * @param speeds Speed measured at each power step (magnitude)
+ * @param table Output table
+ * @param direction 1 or -1
+ */
+static void motorBuildLinearization(int *speeds, signed char *table, const int direction)
+{
+	//Make the response monotonic so it can be inverted
+	for (int i = 1; i <= MOTOR_CAL_STEPS; i++)
+	{
+		speeds[i] = speeds[i] < speeds[i - 1] ? speeds[i - 1] : speeds[i];
+	}
+
+	const int top = speeds[MOTOR_CAL_STEPS];
+	int step = 0;
+
+	for (int x = 1; x <= MOTOR_MAX_VALUE; x++)
+	{
+		//Speed the linear command `x` asks for
+		const float want = (float)top * x / MOTOR_MAX_VALUE;
+
+		while (step < MOTOR_CAL_STEPS && speeds[step + 1] < want)
+		{
+			step++;
+		}
+
+		//Interpolate power between the bounding steps
+		float power = MOTOR_MAX_VALUE;
+
+		if (step < MOTOR_CAL_STEPS)
+		{
+			const int lo = speeds[step], hi = speeds[step + 1];
+			const float t = hi > lo ? (want - lo) / (hi - lo) : 0.0;
+			power = (step + t) * MOTOR_MAX_VALUE / MOTOR_CAL_STEPS;
+		}
+
+		power = power > MOTOR_MAX_VALUE ? MOTOR_MAX_VALUE : power;
+		table[128 + direction * x] = direction * (int)(power + 0.5);
+	}
+}
+
+/**
+ * Sends a calibration power straight to a port, bypassing compensation and linearization
+ * The thermal model still sees the power
+ */
+static void motorCalibrateOutput(const unsigned char index, const int power)
+{
+	driveMotors[index].lastOutput = power;
+	motorSet(index, power);
+}
+
+/**
+ * Measures a motor's speed across its power range and builds a linearization table from it
+ * Blocks for about 20 seconds with the motor running; the motor should spin freely (or with its
+ * normal load) and the table is printed as a C initializer so it can be stored in flash
+ * The motor is set inactive for the sweep, so the slew rate task leaves it alone, and its previous
+ * state is restored afterwards (stopped)
+ *
+ * @param index Port number of the motor
+ * @param readVelocity Function returning the motor's current (filtered) velocity
+ * @param table Output table of 256 entries
+ */
+void motorCalibrateLinearization(const unsigned char index, int (*readVelocity)(), signed char *table)
+{
+	driveMotor *m = &(driveMotors[index]);
+	const bool wasActive = m->active;
+	int speeds[MOTOR_CAL_STEPS + 1];
+
+	//Keep the slew rate task, and its compensation refreshes, off the port during the sweep
+	setMotorInactive(index);
+	m->raw = false;
+
+	for (int direction = 1; direction >= -1; direction -= 2)
+	{
+		speeds[0] = 0;
+
+		//Step up through the power range and wait for the speed to settle at each step
+		for (int i = 1; i <= MOTOR_CAL_STEPS; i++)
+		{
+			motorCalibrateOutput(index, direction * i * MOTOR_MAX_VALUE / MOTOR_CAL_STEPS);
+			delay(MOTOR_CAL_SETTLE);
+			speeds[i] = abs(readVelocity());
+		}
+
+		motorCalibrateOutput(index, 0);
+		delay(MOTOR_CAL_SETTLE * 4);
+
+		motorBuildLinearization(speeds, table, direction);
+	}
+
+	table[0] = table[1];
+	table[128] = 0;
+
+	//The motor is stopped, so the slew rate controller ramps it back up to its requested speed
+	m->artSpeed = 0;
+	m->active = wasActive;
+
+	//Print the table so it can be pasted into flash
+	printf("const signed char table[256] = {");
+
+	for (int i = 0; i < 256; i++)
+	{
+		printf(i % 16 == 0 ? "\n\t%d," : " %d,", table[i]);
+	}
+
+	printf("\n};\n");
+}
+
+/**
+ * Enables the thermal model of a motor
+ * Current is estimated from the power sent and the measured velocity, and integrated into PTC
+ * heat every slew task cycle
+ *
+ * @param index Port number of the motor
+ * @param freeSpeed Free speed of the motor (or its output) in RPM at MOTOR_THERMAL_VOLTAGE, in
+ * the same units as the velocities given to setMotorMeasuredVelocity
+ */
+void setMotorThermalModel(const unsigned char index, const float freeSpeed)
+{
+	driveMotors[index].freeSpeed = freeSpeed;
+	driveMotors[index].heat = 0;
+	driveMotors[index].thermalCut = 0;
+}
+
+/*
+ * Sets the measured velocity of the motor at index `index` for its thermal model
+ * Without one, the motor is modeled as stalled, which overestimates heating
+ */
+void setMotorMeasuredVelocity(const unsigned char index, const float velocity)
+{
+	driveMotors[index].velocity = velocity;
+}
+
+/*
+ * Enables or disables power capping of motors close to tripping
+ */
+void setMotorThermalCapping(const bool enabled)
+{
+	thermalCapping = enabled;
+}
+
+/*
+ * Gets the estimated current (A) of the motor at index `index`
+ */
+float getMotorCurrent(const unsigned char index)
+{
+	return driveMotors[index].current;
+}
+
+/*
+ * Gets the predicted trip margin of the motor at index `index`
+ * 1 is cold, 0 is at the point of tripping
+ */
+float getMotorTripMargin(const unsigned char index)
+{
+	return 1.0 - driveMotors[index].heat / (MOTOR_THERMAL_TRIP * MOTOR_THERMAL_TRIP);
+}
+
 /*
  * Sets the raw speed of the motor at index `index` to power `power`
+ * The power is recompensated whenever the battery or thermal compensation changes, until the
+ * slew rate controller next moves the motor
  * Warning: The slew rate controller may try to fight this function
  * If you want to bypass slewing, use function `setMotorSpeed_Bypass` instead (or use this
  * function in combination with the function `setMotorInactive`)
  */
-inline void setMotorSpeedRaw(const unsigned char index, const int power)
+void setMotorSpeedRaw(const unsigned char index, const int power)
 {
-	motorSet(index, power);
+	driveMotors[index].rawSpeed = power;
+	driveMotors[index].raw = true;
+	motorOutput(index, power);
 }
 
 /*
  * Gets the raw speed of the motor at index `index`
  */
-inline int getMotorSpeedRaw(const unsigned char index)
+int getMotorSpeedRaw(const unsigned char index)
 {
 	return motorGet(index);
 }
@@ -102,10 +453,221 @@ driveMotor* addMotor(const unsigned char index, const float slewRate)
 	m->artSpeed = 0;
 	m->slew = slewRate;
 	m->active = true;
+	m->group = MOTOR_NO_GROUP;
+	m->scale = 1.0;
+	m->linearization = NULL;
+	m->lastOutput = 0;
+	m->rawSpeed = 0;
+	m->raw = false;
+	m->freeSpeed = 0;
+	m->velocity = 0;
+	m->current = 0;
+	m->heat = 0;
+	m->thermalCut = 0;
 
 	return m;
 }
 
+/**
+ * Initializes a motor group
+ * Reinitializing a group stops its old members and returns them to individual control
+ *
+ * @param group Index of the group (less than MOTOR_GROUP_NUM)
+ * @param slewRate Slew rate of the group
+ */
+motorGroup* addMotorGroup(const unsigned char group, const float slewRate)
+{
+	motorGroup *g = &(motorGroups[group]);
+
+	//Release the members of a previous use of this group, stopped, so they are not left driven by nothing
+	for (unsigned char i = 0; i < g->count; i++)
+	{
+		const unsigned char index = g->members[i];
+
+		driveMotors[index].group = MOTOR_NO_GROUP;
+		driveMotors[index].reqSpeed = 0;
+		driveMotors[index].artSpeed = 0;
+		motorOutput(index, 0);
+	}
+
+	g->count = 0;
+	g->reqSpeed = 0;
+	g->artSpeed = 0;
+	g->slew = slewRate;
+	g->active = true;
+
+	return g;
+}
+
+/**
+ * Removes a motor from whichever group lists it, keeping the other members in order
+ */
+static void motorGroupRemove(const unsigned char index)
+{
+	for (int group = 0; group < MOTOR_GROUP_NUM; group++)
+	{
+		motorGroup *g = &(motorGroups[group]);
+
+		for (int i = 0; i < g->count; i++)
+		{
+			if (g->members[i] == index)
+			{
+				for (int j = i + 1; j < g->count; j++)
+				{
+					g->members[j - 1] = g->members[j];
+				}
+
+				g->count--;
+				break;
+			}
+		}
+	}
+
+	driveMotors[index].group = MOTOR_NO_GROUP;
+}
+
+/**
+ * Adds a motor to a group, moving it out of any group it was already in
+ * The motor is then slewed and set only through the group; its linearization table and
+ * thermal model (including accumulated heat) are kept
+ *
+ * @param group Index of the group
+ * @param index Port number of the motor
+ * @param scale Output multiplier for this motor (-1 to reverse it)
+ */
+void addMotorToGroup(const unsigned char group, const unsigned char index, const float scale)
+{
+	motorGroup *g = &(motorGroups[group]);
+	driveMotor *m = &(driveMotors[index]);
+
+	//A motor driven by two groups would be set twice per pass and follow whichever wrote last
+	motorGroupRemove(index);
+
+	if (g->count >= MOTOR_NUM)
+	{
+		return;
+	}
+
+	g->members[g->count++] = index;
+
+	m->reqSpeed = 0;
+	m->artSpeed = 0;
+	m->slew = g->slew;
+	m->active = true;
+	m->group = group;
+	m->scale = scale;
+	m->raw = false;
+}
+
+/*
+ * Sets the speed of every motor in group `group` to power `power`
+ */
+void setMotorGroupSpeed(const unsigned char group, const int power)
+{
+	motorGroups[group].reqSpeed = power;
+}
+
+/*
+ * Sets the speed of every motor in group `group` to power `power`, and bypasses slewing
+ */
+void setMotorGroupSpeed_Bypass(const unsigned char group, const int power)
+{
+	motorGroups[group].reqSpeed = power;
+	motorGroups[group].artSpeed = power;
+}
+
+/**
+ * Sets the speeds of several groups as one batch, which the slew rate task always sees whole
+ * Use this when the groups must change together, e.g. the sides of a drive
+ *
+ * @param groups Indices of the groups
+ * @param powers Power for each group
+ * @param count Number of groups
+ */
+void setMotorGroupSpeeds(const unsigned char *groups, const int *powers, const unsigned char count)
+{
+	//Normally created by startMotorSlewRateTask, but a batch may be set before the task starts
+	if (motorGroupMutex == NULL)
+	{
+		motorGroupMutex = mutexCreate();
+	}
+
+	mutexTake(motorGroupMutex, -1);
+
+	for (unsigned char i = 0; i < count; i++)
+	{
+		motorGroups[groups[i]].reqSpeed = powers[i];
+	}
+
+	mutexGive(motorGroupMutex);
+}
+
+/*
+ * Gets the group at index `group`
+ */
+motorGroup* getMotorGroup(const unsigned char group)
+{
+	return &(motorGroups[group]);
+}
+
+/*
+ * Gets the requested speed of group `group`
+ */
+int getMotorGroupSpeed(const unsigned char group)
+{
+	return motorGroups[group].reqSpeed;
+}
+
+/*
+ * Sets group `group` to active
+ */
+void setMotorGroupActive(const unsigned char group)
+{
+	motorGroups[group].active = true;
+}
+
+/*
+ * Sets group `group` to inactive
+ */
+void setMotorGroupInactive(const unsigned char group)
+{
+	motorGroups[group].active = false;
+}
+
+/**
+ * Moves an artificial speed one slew step toward a requested speed
+ *
+ * @param artSpeed Current artificial speed
+ * @param reqSpeed Requested speed
+ * @param slew Slew rate
+ * @return New artificial speed
+ */
+static float motorSlewStep(float artSpeed, const int reqSpeed, const float slew)
+{
+	//Increase motor value
+	if (reqSpeed > artSpeed)
+	{
+		artSpeed += slew;
+
+		//Limit speed
+		artSpeed = artSpeed > reqSpeed ? reqSpeed : artSpeed;
+	}
+	//Decrease motor value
+	else if (reqSpeed < artSpeed)
+	{
+		artSpeed -= slew;
+
+		//Limit speed
+		artSpeed = artSpeed < reqSpeed ? reqSpeed : artSpeed;
+	}
+
+	//Bound speed
+	artSpeed = artSpeed > MOTOR_MAX_VALUE ? MOTOR_MAX_VALUE : artSpeed;
+	artSpeed = artSpeed < MOTOR_MIN_VALUE ? MOTOR_MIN_VALUE : artSpeed;
+
+	return artSpeed;
+}
+
 /**
  * Updates the power of each motor to best match the requested power
  */
@@ -123,16 +685,57 @@ static void motorSlewRateTask()
 	//Current motor
 	driveMotor *currentMotor;
 
+	//Current group
+	motorGroup *currentGroup;
+
+	//Battery sample countdown
+	static unsigned char batteryCountdown = 0;
+
+	//Resend every output when the battery compensation changes
+	bool refresh = false;
+
+	//Time of the previous cycle for the thermal model
+	static unsigned long prevTime = 0;
+
+	PROFILE_BEGIN(motorProfileSite);
+
+	if (batteryCountdown-- == 0)
+	{
+		batteryCountdown = MOTOR_BATTERY_SAMPLE - 1;
+		refresh = motorSampleBattery();
+	}
+
+	//Step thermal models (resending outputs whose power cap changed)
+	const unsigned long now = millis();
+
+	if (prevTime != 0 && motorStepThermal((now - prevTime) / 1000.0))
+	{
+		refresh = true;
+	}
+
+	prevTime = now;
+
 	//Batch motor power update
 	for (motorIndex = 0; motorIndex < MOTOR_NUM; motorIndex++)
 	{
+		//Grouped motors are updated with their group below
+		if ((currentMotor = &(driveMotors[motorIndex]))->group != MOTOR_NO_GROUP)
+		{
+			continue;
+		}
+
 		/*
-		 * Assign the driveMotor at motorIndex to currentMotor and check the active flag:
-		 * if the motor is not active, do not let the controller update the motor's power
-		 * by skipping that motor's update cycle
+		 * Check the active flag: if the motor is not active, do not let the controller update
+		 * the motor's power by skipping that motor's update cycle
+		 * A raw output is still recompensated, since it was compensated when it was set
 		 */
-		if (!(currentMotor = &(driveMotors[motorIndex]))->active)
+		if (!currentMotor->active)
 		{
+			if (refresh && currentMotor->raw)
+			{
+				motorOutput(motorIndex, currentMotor->rawSpeed);
+			}
+
 			continue;
 		}
 
@@ -143,34 +746,77 @@ static void motorSlewRateTask()
 		//If the motor value needs to change
 		if (motorTmpArtSpd != motorTmpReq)
 		{
-			//Increase motor value
-			if (motorTmpReq > motorTmpArtSpd)
-			{
-				motorTmpArtSpd += currentMotor->slew;
+			motorTmpArtSpd = motorSlewStep(motorTmpArtSpd, motorTmpReq, currentMotor->slew);
 
-				//Limit speed
-				motorTmpArtSpd = motorTmpArtSpd > motorTmpReq ? motorTmpReq : motorTmpArtSpd;
-			}
-			//Decrease motor value
-			else if (motorTmpReq < motorTmpArtSpd)
+			//Send updated speed to motor
+			motorOutput(motorIndex, motorTmpArtSpd);
+
+			//Send updated speed back to current motor
+			currentMotor->artSpeed = motorTmpArtSpd;
+			currentMotor->raw = false;
+		}
+		//Resend the current output, raw or slewed, with the new compensation
+		else if (refresh)
+		{
+			motorOutput(motorIndex, currentMotor->raw ? currentMotor->rawSpeed : motorTmpArtSpd);
+		}
+	}
+
+	//Read every group's requested speed at once, so a batch from setMotorGroupSpeeds is never split
+	int groupReqSpeeds[MOTOR_GROUP_NUM];
+
+	mutexTake(motorGroupMutex, -1);
+
+	for (unsigned char groupIndex = 0; groupIndex < MOTOR_GROUP_NUM; groupIndex++)
+	{
+		groupReqSpeeds[groupIndex] = motorGroups[groupIndex].reqSpeed;
+	}
+
+	mutexGive(motorGroupMutex);
+
+	//Batch group power update (one slew calculation per group, all members set together)
+	for (unsigned char groupIndex = 0; groupIndex < MOTOR_GROUP_NUM; groupIndex++)
+	{
+		if (!(currentGroup = &(motorGroups[groupIndex]))->active || currentGroup->count == 0)
+		{
+			continue;
+		}
+
+		motorTmpArtSpd = currentGroup->artSpeed;
+		motorTmpReq = groupReqSpeeds[groupIndex];
+
+		if (motorTmpArtSpd != motorTmpReq || refresh)
+		{
+			motorTmpArtSpd = motorSlewStep(motorTmpArtSpd, motorTmpReq, currentGroup->slew);
+			currentGroup->artSpeed = motorTmpArtSpd;
+
+			for (unsigned char i = 0; i < currentGroup->count; i++)
 			{
-				motorTmpArtSpd -= currentMotor->slew;
+				motorIndex = currentGroup->members[i];
+				currentMotor = &(driveMotors[motorIndex]);
 
-				//Limit speed
-				motorTmpArtSpd = motorTmpArtSpd < motorTmpReq ? motorTmpReq : motorTmpArtSpd;
-			}
+				//Inactive members (e.g. being calibrated) are left alone
+				if (!currentMotor->active)
+				{
+					continue;
+				}
 
-			//Bound speed
-			motorTmpArtSpd = motorTmpArtSpd > MOTOR_MAX_VALUE ? MOTOR_MAX_VALUE : motorTmpArtSpd;
-			motorTmpArtSpd = motorTmpArtSpd < MOTOR_MIN_VALUE ? MOTOR_MIN_VALUE : motorTmpArtSpd;
+				//Scaled output, bounded again in case the scale is above one
+				float memberSpd = motorTmpArtSpd * currentMotor->scale;
+				memberSpd = memberSpd > MOTOR_MAX_VALUE ? MOTOR_MAX_VALUE : memberSpd;
+				memberSpd = memberSpd < MOTOR_MIN_VALUE ? MOTOR_MIN_VALUE : memberSpd;
 
-			//Send updated speed to motor
-			motorSet(motorIndex, (int)motorTmpArtSpd);
+				motorOutput(motorIndex, memberSpd);
+				currentMotor->raw = false;
 
-			//Send updated speed back to current motor
-			currentMotor->artSpeed = motorTmpArtSpd;
+				//Keep per-motor speeds readable through getMotorSpeed
+				currentMotor->reqSpeed = (int)(motorTmpReq * currentMotor->scale);
+				currentMotor->artSpeed = memberSpd;
+			}
 		}
 	}
+
+	PROFILE_END(motorProfileSite);
 }
 
 /*
@@ -178,5 +824,12 @@ static void motorSlewRateTask()
  */
 void startMotorSlewRateTask()
 {
+	PROFILE_REGISTER(motorProfileSite, "motors");
+
+	if (motorGroupMutex == NULL)
+	{
+		motorGroupMutex = mutexCreate();
+	}
+
 	taskRunLoop(motorSlewRateTask, 20);
 }
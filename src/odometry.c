@@ -0,0 +1,156 @@
+#include "API.h"
+#include "odometry.h"
+#include "math.h"
+#include "util.h"
+
+//Chassis odometry
+static odometry chassisOdom = {.published = DOUBLE_BUFFER(chassisOdom.snapshots)};
+
+/**
+ * Initializes odometry
+ *
+ * @param left Left side quad encoder (counts up driving forward)
+ * @param right Right side quad encoder (counts up driving forward)
+ * @param gyro Gyro (counts up turning counterclockwise), or NULL to use the encoders
+ * @param wheelDiam Tracking wheel diameter in inches
+ * @param trackWidth Distance between the left and right tracking wheels in inches
+ */
+void odom_Init(Encoder left, Encoder right, Gyro gyro, const float wheelDiam, const float trackWidth)
+{
+	chassisOdom.left = left;
+	chassisOdom.right = right;
+	chassisOdom.gyro = gyro;
+
+	chassisOdom.inchesPerTick = (PI * wheelDiam) / UTIL_QUAD_TPR;
+	chassisOdom.trackWidth = trackWidth;
+
+	chassisOdom.prevLeft = encoderGet(left);
+	chassisOdom.prevRight = encoderGet(right);
+	chassisOdom.prevGyro = gyro == NULL ? 0 : gyroGet(gyro);
+
+	//The odometry task is not running yet, so the pose can be set and published directly
+	//A pose set with odom_SetPose before this is still applied by the first update
+	chassisOdom.pose.x = 0.0;
+	chassisOdom.pose.y = 0.0;
+	chassisOdom.pose.theta = 0.0;
+	chassisOdom.pose.time = millis();
+
+	doubleBuffer_Write(&(chassisOdom.published), &(chassisOdom.pose));
+}
+
+/**
+ * Sets the current pose
+ * Takes effect at the start of the odometry task's next update, so it never races the integration
+ * May be called before odom_Init to give the starting pose
+ *
+ * @param x X position in inches
+ * @param y Y position in inches
+ * @param theta Heading in radians
+ */
+void odom_SetPose(const float x, const float y, const float theta)
+{
+	//Created here rather than in odom_Init, since this may be called first
+	if (chassisOdom.resetMutex == NULL)
+	{
+		chassisOdom.resetMutex = mutexCreate();
+	}
+
+	mutexTake(chassisOdom.resetMutex, -1);
+
+	chassisOdom.resetPose.x = x;
+	chassisOdom.resetPose.y = y;
+	chassisOdom.resetPose.theta = theta;
+	chassisOdom.resetPose.time = millis();
+	chassisOdom.resetPending = true;
+
+	mutexGive(chassisOdom.resetMutex);
+}
+
+/**
+ * Copies the latest published pose
+ * Lock-free and safe to call from any task
+ *
+ * @param out Pose to copy into
+ */
+void odom_GetPose(odomPose *out)
+{
+	doubleBuffer_Read(&(chassisOdom.published), out, 0, sizeof(odomPose));
+}
+
+/**
+ * Advances a pose along an arc
+ *
+ * @param pose The pose
+ * @param dLeft Left side travel in inches
+ * @param dRight Right side travel in inches
+ * @param dTheta Heading change in radians
+ */
+void odom_Integrate(odomPose *pose, const float dLeft, const float dRight, const float dTheta)
+{
+	const float dCenter = (dLeft + dRight) * 0.5;
+	float chord = dCenter;
+
+	//Travel along an arc covers a shorter chord than its length
+	if (fabsf(dTheta) > ODOM_SMALL_ANGLE)
+	{
+		chord = 2.0 * (dCenter / dTheta) * sinf(dTheta * 0.5);
+	}
+
+	//The chord points along the average heading over the arc
+	const float midTheta = pose->theta + dTheta * 0.5;
+
+	pose->x += chord * cosf(midTheta);
+	pose->y += chord * sinf(midTheta);
+	pose->theta += dTheta;
+}
+
+/**
+ * Reads the sensors, integrates, and publishes the new pose
+ */
+void odom_Update()
+{
+	//Only this task writes the working pose, so resets are applied here
+	if (chassisOdom.resetPending)
+	{
+		mutexTake(chassisOdom.resetMutex, -1);
+		chassisOdom.pose = chassisOdom.resetPose;
+		chassisOdom.resetPending = false;
+		mutexGive(chassisOdom.resetMutex);
+	}
+
+	const int leftNow = encoderGet(chassisOdom.left);
+	const int rightNow = encoderGet(chassisOdom.right);
+
+	const float dLeft = (leftNow - chassisOdom.prevLeft) * chassisOdom.inchesPerTick;
+	const float dRight = (rightNow - chassisOdom.prevRight) * chassisOdom.inchesPerTick;
+
+	chassisOdom.prevLeft = leftNow;
+	chassisOdom.prevRight = rightNow;
+
+	float dTheta;
+
+	//Gyro heading is not affected by wheel slip, so prefer it when present
+	if (chassisOdom.gyro != NULL)
+	{
+		const int gyroNow = gyroGet(chassisOdom.gyro);
+		dTheta = (gyroNow - chassisOdom.prevGyro) * (PI / 180.0);
+		chassisOdom.prevGyro = gyroNow;
+	}
+	else
+	{
+		dTheta = (dRight - dLeft) / chassisOdom.trackWidth;
+	}
+
+	odom_Integrate(&(chassisOdom.pose), dLeft, dRight, dTheta);
+	chassisOdom.pose.time = millis();
+
+	doubleBuffer_Write(&(chassisOdom.published), &(chassisOdom.pose));
+}
+
+/**
+ * Starts the odometry task
+ */
+void startOdometryTask()
+{
+	taskRunLoop(odom_Update, ODOM_TASK_DELAY);
+}
@@ -0,0 +1,140 @@
+#include "API.h"
+#include "doubleBuffer.h"
+#include "oversample.h"
+
+//Accumulators, indexed by channel - 1
+static oversampleChannel oversampleChannels[BOARD_NR_ADC_PINS];
+
+//Outputs: the task writes the back buffer and then flips, readers copy the front one
+static oversampleValue oversampleBuffers[2][BOARD_NR_ADC_PINS];
+static doubleBuffer oversamplePublished = DOUBLE_BUFFER(oversampleBuffers);
+
+/**
+ * Registers an analog channel for oversampling
+ *
+ * @param channel Analog channel (1 to BOARD_NR_ADC_PINS)
+ * @param bits Extra bits of resolution (0 to OVERSAMPLE_MAX_BITS), each costs 4x the samples per output
+ * @param calibrate Subtract the analogCalibrate offset (the sensor must be at rest when this is called)
+ * @return Whether the channel was registered
+ */
+bool oversample_AddChannel(const unsigned char channel, const unsigned char bits, const bool calibrate)
+{
+	if (channel < 1 || channel > BOARD_NR_ADC_PINS || bits > OVERSAMPLE_MAX_BITS)
+	{
+		return false;
+	}
+
+	oversampleChannel *c = &(oversampleChannels[channel - 1]);
+	c->bits = bits;
+	c->samples = 1U << (2 * bits);
+	c->offset = calibrate ? analogCalibrate(channel) : 0;
+	c->sum = 0;
+	c->taken = 0;
+
+	for (int b = 0; b < 2; b++)
+	{
+		oversampleValue *v = &(oversampleBuffers[b][channel - 1]);
+		v->value = 0;
+		v->average = 0;
+		v->time = 0;
+		v->count = 0;
+	}
+
+	__sync_synchronize();
+	c->enabled = true;
+
+	return true;
+}
+
+/**
+ * Samples every registered channel once and publishes any finished outputs
+ * Called by the oversampling task; only call directly if the task is not running
+ */
+void oversample_Sample()
+{
+	const oversampleValue *front = doubleBuffer_GetFront(&oversamplePublished);
+	oversampleValue *back = doubleBuffer_GetBack(&oversamplePublished);
+	bool finished = false;
+
+	for (int i = 0; i < BOARD_NR_ADC_PINS; i++)
+	{
+		oversampleChannel *c = &(oversampleChannels[i]);
+
+		//Carry the front value over so the back buffer is complete when it flips
+		back[i] = front[i];
+
+		if (!c->enabled)
+		{
+			continue;
+		}
+
+		//Offsets can take a sample below zero, so accumulate raw counts and remove them once
+		c->sum += analogRead(i + 1);
+		c->taken++;
+
+		if (c->taken < c->samples)
+		{
+			continue;
+		}
+
+		//Decimate: 4^bits samples summed and shifted right by bits gives 12 + bits bits
+		const int total = (int)c->sum - c->offset * (int)c->samples;
+		back[i].value = (total >> c->bits) << (OVERSAMPLE_MAX_BITS - c->bits);
+		back[i].average = (float)total / c->samples;
+		back[i].time = micros();
+		back[i].count++;
+
+		c->sum = 0;
+		c->taken = 0;
+		finished = true;
+	}
+
+	if (finished)
+	{
+		doubleBuffer_Flip(&oversamplePublished);
+	}
+}
+
+/**
+ * Gets the latest decimated value of a channel
+ * Lock-free and safe to call from any task
+ *
+ * @param channel Analog channel (1 to BOARD_NR_ADC_PINS)
+ * @param out Value to fill
+ */
+void oversample_Get(const unsigned char channel, oversampleValue *out)
+{
+	doubleBuffer_Read(&oversamplePublished, out, (channel - 1) * sizeof(oversampleValue), sizeof(oversampleValue));
+}
+
+/**
+ * Gets the latest decimated value of a channel in analogReadCalibratedHR units
+ *
+ * @param channel Analog channel (1 to BOARD_NR_ADC_PINS)
+ */
+int oversample_GetValue(const unsigned char channel)
+{
+	oversampleValue v;
+	oversample_Get(channel, &v);
+	return v.value;
+}
+
+/**
+ * Gets the latest mean of a channel in ADC counts
+ *
+ * @param channel Analog channel (1 to BOARD_NR_ADC_PINS)
+ */
+float oversample_GetAverage(const unsigned char channel)
+{
+	oversampleValue v;
+	oversample_Get(channel, &v);
+	return v.average;
+}
+
+/*
+ * Starts the oversampling task
+ */
+void startOversampleTask()
+{
+	taskRunLoop(oversample_Sample, OVERSAMPLE_PERIOD);
+}
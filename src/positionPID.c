@@ -31,6 +31,8 @@ void pos_PID_InitController(pos_PID *pid, const float kP, const float kI, const
 
 	pid->targetPos = 0;
 
+	pid->schedule = NULL;
+
 	pid->outVal = 0;
 }
 
@@ -65,6 +67,8 @@ void pos_PID_InitController_Full(pos_PID *pid, const float kP, const float kI, c
 
 	pid->targetPos = 0;
 
+	pid->schedule = NULL;
+
 	pid->outVal = 0;
 }
 
@@ -79,6 +83,17 @@ void pos_PID_SetTargetPosition(pos_PID *pid, const int targetPos)
 	pid->targetPos = targetPos;
 }
 
+/**
+ * Sets a gain schedule which overrides kP, kI, and kD each step
+ *
+ * @param pid The PID controller
+ * @param schedule The gain schedule, or NULL to keep the current gains fixed
+ */
+void pos_PID_SetGainSchedule(pos_PID *pid, gainSchedule *schedule)
+{
+	pid->schedule = schedule;
+}
+
 /**
  * Gets the current error
  *
@@ -116,10 +131,19 @@ int pos_PID_StepController(pos_PID *pid, const float sens)
 	//Calculate error
 	pid->error = pid->targetPos - sens;
 
+	//Pull gains from the schedule
+	if (pid->schedule != NULL)
+	{
+		gainSchedule_Update(pid->schedule, pid->targetPos, sens);
+		pid->kP = pid->schedule->kP;
+		pid->kI = pid->schedule->kI;
+		pid->kD = pid->schedule->kD;
+	}
+
 	//If error is higher than errorThreshold and integral is less than integralLimit, sum
 	if (abs(pid->error) > pid->errorThreshold && abs(pid->integral) < pid->integralLimit)
 	{
-		pid->integral = pid->integral + (pid->error * pid->dt);
+		pid->integral = pid->integral + (pid->error * (int)pid->dt);
 
 		//Reset integral if controller reached targetPos or overshot
 		if (pid->error == 0 || sign(pid->error) != sign(pid->prevError))
@@ -135,7 +159,7 @@ int pos_PID_StepController(pos_PID *pid, const float sens)
 	}
 
 	///Calculate derivative
-	pid->derivative = (pid->error - pid->prevError) / pid->dt;
+	pid->derivative = (pid->error - pid->prevError) / (int)pid->dt;
 	pid->prevError = pid->error;
 
 	//Calculate output
@@ -0,0 +1,288 @@
+#include "API.h"
+#include "profiler.h"
+#include "util.h"
+
+//Registered sites
+static profilerSite profilerSites[PROFILER_SITES];
+static volatile int profilerSiteCount = 0;
+
+//Cost of one begin/end pair in ns, removed from each measurement
+static unsigned int profilerOverhead = 0;
+
+/**
+ * Clears one site's statistics
+ */
+static void profilerClear(profilerSite *s)
+{
+	s->count = 0;
+	s->total = 0;
+	s->min = 0xFFFFFFFF;
+	s->max = 0;
+	s->periodMin = 0xFFFFFFFF;
+	s->periodMax = 0;
+	s->running = false;
+
+	for (int i = 0; i < PROFILER_BUCKETS; i++)
+	{
+		s->histogram[i] = 0;
+	}
+}
+
+/**
+ * Registers a profiled site
+ *
+ * @param name Name shown in reports (kept by pointer, 8 characters fit on the LCD)
+ * @return Site ID, or -1 if all sites are used (-1 is ignored by begin and end)
+ */
+int profiler_Register(const char *name)
+{
+	const int site = __sync_fetch_and_add(&profilerSiteCount, 1);
+
+	if (site >= PROFILER_SITES)
+	{
+		profilerSiteCount = PROFILER_SITES;
+		return -1;
+	}
+
+	profilerSites[site].name = name;
+	profilerClear(&(profilerSites[site]));
+
+	return site;
+}
+
+/**
+ * Marks the start of a profiled section
+ *
+ * @param site Site ID from profiler_Register
+ */
+void profiler_Begin(const int site)
+{
+	if (site < 0)
+	{
+		return;
+	}
+
+	profilerSite *s = &(profilerSites[site]);
+	const unsigned long now = micros();
+
+	//Start to start period
+	if (s->count > 0)
+	{
+		const unsigned int period = now - s->start;
+		s->periodMin = period < s->periodMin ? period : s->periodMin;
+		s->periodMax = period > s->periodMax ? period : s->periodMax;
+	}
+
+	s->start = now;
+	s->running = true;
+}
+
+/**
+ * Marks the end of a profiled section and records its duration
+ *
+ * @param site Site ID from profiler_Register
+ */
+void profiler_End(const int site)
+{
+	const unsigned long now = micros();
+
+	if (site < 0 || !profilerSites[site].running)
+	{
+		return;
+	}
+
+	profilerSite *s = &(profilerSites[site]);
+	s->running = false;
+
+	//Duration without the profiler's own cost (wrap safe)
+	unsigned int duration = now - s->start;
+	const unsigned int overhead = profilerOverhead / 1000;
+	duration = duration > overhead ? duration - overhead : 0;
+
+	s->count++;
+	s->total += duration;
+	s->min = duration < s->min ? duration : s->min;
+	s->max = duration > s->max ? duration : s->max;
+
+	//Log bucket: number of significant bits
+	const int bucket = duration == 0 ? 0 : 32 - __builtin_clz(duration);
+	s->histogram[bucket < PROFILER_BUCKETS ? bucket : PROFILER_BUCKETS - 1]++;
+}
+
+/**
+ * Clears the statistics of every site (registrations are kept)
+ */
+void profiler_Reset()
+{
+	for (int i = 0; i < profilerSiteCount; i++)
+	{
+		profilerClear(&(profilerSites[i]));
+	}
+}
+
+/**
+ * Times empty begin/end pairs and removes that cost from later measurements
+ *
+ * @return Overhead of one begin/end pair in ns
+ */
+unsigned int profiler_MeasureOverhead()
+{
+	profilerSite *s = &(profilerSites[PROFILER_SITES - 1]);
+	const profilerSite saved = *s;
+
+	profilerOverhead = 0;
+
+	//Use the last slot as scratch so registered sites are untouched
+	const unsigned long start = micros();
+
+	for (int i = 0; i < PROFILER_CALIBRATION; i++)
+	{
+		profiler_Begin(PROFILER_SITES - 1);
+		profiler_End(PROFILER_SITES - 1);
+	}
+
+	const unsigned int elapsed = micros() - start;
+
+	*s = saved;
+	profilerOverhead = (unsigned long long)elapsed * 1000 / PROFILER_CALIBRATION;
+
+	return profilerOverhead;
+}
+
+/**
+ * Gets the number of registered sites
+ */
+int profiler_GetSiteCount()
+{
+	return profilerSiteCount;
+}
+
+/**
+ * Gets a site's statistics
+ *
+ * @param site Site ID from profiler_Register
+ */
+const profilerSite* profiler_GetSite(const int site)
+{
+	return &(profilerSites[site]);
+}
+
+/**
+ * Gets the average execution time of a site in us
+ *
+ * @param site Site ID from profiler_Register
+ */
+unsigned int profiler_GetAverage(const int site)
+{
+	const profilerSite *s = &(profilerSites[site]);
+	return s->count == 0 ? 0 : s->total / s->count;
+}
+
+/**
+ * Gets the execution time below which a fraction of a site's runs finished
+ * Resolved to the upper edge of a histogram bucket
+ *
+ * @param site Site ID from profiler_Register
+ * @param fraction Fraction of runs (e.g. 0.99)
+ */
+unsigned int profiler_GetPercentile(const int site, const float fraction)
+{
+	const profilerSite *s = &(profilerSites[site]);
+	const unsigned int target = s->count * fraction;
+	unsigned int seen = 0;
+
+	for (int i = 0; i < PROFILER_BUCKETS - 1; i++)
+	{
+		seen += s->histogram[i];
+
+		if (seen > target)
+		{
+			//Never report past the largest run seen
+			const unsigned int edge = (1U << i) - 1;
+			return edge < s->max ? edge : s->max;
+		}
+	}
+
+	return s->max;
+}
+
+/**
+ * Prints a table of every site
+ *
+ * @param port Where to print (stdout, uart1, or uart2)
+ */
+void profiler_Print(FILE *port)
+{
+	const unsigned long now = micros();
+
+	fprintf(port, "site     count      min    avg    p99    max   period  cpu%%\r\n");
+
+	for (int i = 0; i < profilerSiteCount; i++)
+	{
+		const profilerSite *s = &(profilerSites[i]);
+
+		if (s->count == 0)
+		{
+			fprintf(port, "%-8s %5u\r\n", s->name, 0);
+			continue;
+		}
+
+		//Load as time spent in the site over the average period, in tenths of a percent
+		const unsigned int avg = profiler_GetAverage(i);
+		const unsigned int period = s->count > 1 ? (s->periodMin + s->periodMax) / 2 : 0;
+		const unsigned int load = period == 0 ? 0 : avg * 1000 / period;
+
+		fprintf(port, "%-8s %5u %8u %6u %6u %6u %5u-%-5u %2u.%u\r\n", s->name, s->count, s->min, avg,
+			profiler_GetPercentile(i, 0.99), s->max, s->periodMin, s->periodMax, load / 10, load % 10);
+	}
+
+	fprintf(port, "overhead %u ns per begin/end, t=%lu us\r\n", profilerOverhead, now);
+}
+
+/**
+ * Shows sites on the LCD, one per page (left/right to scroll, center to exit)
+ * Meant as a menu dispatch function (see newMenuWithDispatch)
+ */
+void profiler_ShowOnLCD()
+{
+	int site = 0;
+
+	waitForLCDRelease();
+
+	while (lcdReadButtons(uart1) != LCD_BTN_CENTER)
+	{
+		if (profilerSiteCount == 0)
+		{
+			lcdPrint(uart1, 1, "No profile sites");
+			lcdSetText(uart1, 2, "");
+		}
+		else
+		{
+			const profilerSite *s = &(profilerSites[site]);
+			lcdPrint(uart1, 1, "%-8.8s n%7u", s->name, s->count);
+			lcdPrint(uart1, 2, "%4u %4u %5u", s->count == 0 ? 0 : s->min, profiler_GetAverage(site), s->max);
+		}
+
+		//With no sites there is nothing to scroll to, and site must stay a valid index for when one registers
+		if (lcdReadButtons(uart1) == LCD_BTN_LEFT)
+		{
+			if (profilerSiteCount > 0)
+			{
+				site = site == 0 ? profilerSiteCount - 1 : site - 1;
+			}
+
+			waitForLCDRelease();
+		}
+		else if (lcdReadButtons(uart1) == LCD_BTN_RIGHT)
+		{
+			if (profilerSiteCount > 0)
+			{
+				site = site + 1 >= profilerSiteCount ? 0 : site + 1;
+			}
+
+			waitForLCDRelease();
+		}
+
+		delay(100);
+	}
+}
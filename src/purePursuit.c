@@ -0,0 +1,391 @@
+#include "API.h"
+#include "purePursuit.h"
+#include "math.h"
+
+/**
+ * Initializes a pure pursuit path follower
+ *
+ * @param pp The path follower
+ * @param buffer Storage for generated path points
+ * @param capacity Number of points `buffer` can hold
+ * @param lookahead Lookahead distance in inches
+ * @param trackWidth Distance between left and right wheels in inches
+ * @param wheelDiam Drive wheel diameter in inches
+ */
+void pp_Init(purePursuit *pp, ppPathPoint *buffer, const unsigned int capacity, const float lookahead, const float trackWidth, const float wheelDiam)
+{
+	pp->path = buffer;
+	pp->size = 0;
+	pp->capacity = capacity;
+
+	pp->lookahead = lookahead;
+	pp->maxVelocity = 40.0;
+	pp->maxAccel = 60.0;
+	pp->turnK = 2.0;
+	pp->stopDistance = 1.0;
+	pp->trackWidth = trackWidth;
+	pp->wheelDiam = wheelDiam;
+
+	pp->leftController = NULL;
+	pp->rightController = NULL;
+
+	pp_Reset(pp);
+}
+
+/**
+ * Sets speed limits
+ *
+ * @param pp The path follower
+ * @param maxVelocity Top speed in in/s
+ * @param maxAccel Acceleration limit in in/s^2
+ * @param turnK Speed through curves, as speed = turnK / curvature
+ */
+void pp_SetLimits(purePursuit *pp, const float maxVelocity, const float maxAccel, const float turnK)
+{
+	pp->maxVelocity = maxVelocity;
+	pp->maxAccel = maxAccel;
+	pp->turnK = turnK;
+}
+
+/**
+ * Sets the velocity controllers whose targets are driven by the path follower
+ * Step them with their sensors as usual; each step of the follower sets their target velocity
+ *
+ * @param pp The path follower
+ * @param left Left side velocity controller
+ * @param right Right side velocity controller
+ */
+void pp_SetVelocityControllers(purePursuit *pp, vel_PID *left, vel_PID *right)
+{
+	pp->leftController = left;
+	pp->rightController = right;
+}
+
+/**
+ * Generates a path from waypoints: injects points, smooths, and annotates each point with
+ * distance, curvature, and target velocity
+ * Call once before following; this is too slow to run every step
+ *
+ * @param pp The path follower
+ * @param waypoints Waypoints to pass through (at least two)
+ * @param count Number of waypoints
+ * @param spacing Distance between generated points in inches
+ * @param smoothing Smoothing weight in [0, 1) (0 leaves corners sharp)
+ * @return Number of points generated (limited by the buffer capacity)
+ */
+unsigned int pp_GeneratePath(purePursuit *pp, const ppWaypoint *waypoints, const unsigned int count, const float spacing, const float smoothing)
+{
+	ppPathPoint *path = pp->path;
+	unsigned int n = 0;
+
+	//Inject evenly spaced points along each segment
+	for (unsigned int i = 0; i + 1 < count && n < pp->capacity; i++)
+	{
+		const float dx = waypoints[i + 1].x - waypoints[i].x;
+		const float dy = waypoints[i + 1].y - waypoints[i].y;
+		int steps = (int)ceilf(sqrtf(dx * dx + dy * dy) / spacing);
+		steps = steps < 1 ? 1 : steps;
+
+		for (int k = 0; k < steps && n < pp->capacity; k++, n++)
+		{
+			path[n].x = waypoints[i].x + dx * k / steps;
+			path[n].y = waypoints[i].y + dy * k / steps;
+		}
+	}
+
+	if (n < pp->capacity && count > 0)
+	{
+		path[n].x = waypoints[count - 1].x;
+		path[n].y = waypoints[count - 1].y;
+		n++;
+	}
+
+	pp->size = n;
+
+	//The injected positions are kept in the (not yet used) velocity and curvature fields while
+	//smoothing pulls each point toward both its original position and its neighbors
+	for (unsigned int i = 0; i < n; i++)
+	{
+		path[i].velocity = path[i].x;
+		path[i].curvature = path[i].y;
+	}
+
+	const float a = 1.0 - smoothing, b = smoothing;
+
+	for (int pass = 0; pass < PP_SMOOTH_MAX_PASSES && smoothing > 0; pass++)
+	{
+		float change = 0.0;
+
+		for (unsigned int i = 1; i + 1 < n; i++)
+		{
+			const float nx = path[i].x + a * (path[i].velocity - path[i].x) + b * (path[i - 1].x + path[i + 1].x - 2.0 * path[i].x);
+			const float ny = path[i].y + a * (path[i].curvature - path[i].y) + b * (path[i - 1].y + path[i + 1].y - 2.0 * path[i].y);
+
+			change += fabsf(nx - path[i].x) + fabsf(ny - path[i].y);
+			path[i].x = nx;
+			path[i].y = ny;
+		}
+
+		if (change < PP_SMOOTH_TOLERANCE)
+		{
+			break;
+		}
+	}
+
+	//Distance along the path
+	for (unsigned int i = 0; i < n; i++)
+	{
+		path[i].distance = i == 0 ? 0.0 : path[i - 1].distance + hypotf(path[i].x - path[i - 1].x, path[i].y - path[i - 1].y);
+	}
+
+	//Curvature from the circle through each point and its neighbors
+	for (unsigned int i = 0; i < n; i++)
+	{
+		path[i].curvature = 0.0;
+
+		if (i > 0 && i + 1 < n)
+		{
+			const float ax = path[i].x - path[i - 1].x, ay = path[i].y - path[i - 1].y;
+			const float bx = path[i + 1].x - path[i].x, by = path[i + 1].y - path[i].y;
+			const float cx = path[i + 1].x - path[i - 1].x, cy = path[i + 1].y - path[i - 1].y;
+			const float denom = sqrtf((ax * ax + ay * ay) * (bx * bx + by * by) * (cx * cx + cy * cy));
+
+			if (denom > 1e-6)
+			{
+				path[i].curvature = 2.0 * fabsf(ax * by - ay * bx) / denom;
+			}
+		}
+	}
+
+	//Slow down through curves, then make sure every slowdown (and the stop) is reachable
+	for (unsigned int i = 0; i < n; i++)
+	{
+		const float curveLimit = path[i].curvature > 1e-6 ? pp->turnK / path[i].curvature : pp->maxVelocity;
+		path[i].velocity = curveLimit < pp->maxVelocity ? curveLimit : pp->maxVelocity;
+	}
+
+	if (n > 0)
+	{
+		path[n - 1].velocity = 0.0;
+	}
+
+	for (int i = (int)n - 2; i >= 0; i--)
+	{
+		const float d = path[i + 1].distance - path[i].distance;
+		const float reachable = sqrtf(path[i + 1].velocity * path[i + 1].velocity + 2.0 * pp->maxAccel * d);
+		path[i].velocity = reachable < path[i].velocity ? reachable : path[i].velocity;
+	}
+
+	pp_Reset(pp);
+
+	return n;
+}
+
+/**
+ * Restarts following from the beginning of the path
+ *
+ * @param pp The path follower
+ */
+void pp_Reset(purePursuit *pp)
+{
+	pp->closestIndex = 0;
+	pp->lookaheadIndex = 0;
+	pp->lookaheadFrac = 0.0;
+	pp->lookaheadX = pp->size > 0 ? pp->path[0].x : 0.0;
+	pp->lookaheadY = pp->size > 0 ? pp->path[0].y : 0.0;
+
+	pp->prevTime = 0;
+
+	pp->velocity = 0.0;
+	pp->curvature = 0.0;
+	pp->leftVelocity = 0.0;
+	pp->rightVelocity = 0.0;
+	pp->done = pp->size < 2;
+}
+
+/**
+ * Gets whether the end of the path was reached
+ *
+ * @param pp The path follower
+ */
+bool pp_IsDone(purePursuit *pp)
+{
+	return pp->done;
+}
+
+/**
+ * Gets the left wheel target velocity in RPM
+ *
+ * @param pp The path follower
+ */
+float pp_GetLeftVelocity(purePursuit *pp)
+{
+	return pp->leftVelocity;
+}
+
+/**
+ * Gets the right wheel target velocity in RPM
+ *
+ * @param pp The path follower
+ */
+float pp_GetRightVelocity(purePursuit *pp)
+{
+	return pp->rightVelocity;
+}
+
+/**
+ * Finds where the lookahead circle leaves a path segment
+ *
+ * @return Fraction along the segment, or -1 if the circle does not cross it
+ */
+static float pp_Intersect(const ppPathPoint *start, const ppPathPoint *end, const float cx, const float cy, const float r)
+{
+	const float dx = end->x - start->x, dy = end->y - start->y;
+	const float fx = start->x - cx, fy = start->y - cy;
+
+	const float a = dx * dx + dy * dy;
+	const float b = 2.0 * (fx * dx + fy * dy);
+	const float c = fx * fx + fy * fy - r * r;
+	float disc = b * b - 4.0 * a * c;
+
+	if (a < 1e-9 || disc < 0)
+	{
+		return -1.0;
+	}
+
+	disc = sqrtf(disc);
+
+	//Prefer the crossing further along the segment
+	const float t2 = (-b + disc) / (2.0 * a);
+	if (t2 >= 0 && t2 <= 1)
+	{
+		return t2;
+	}
+
+	const float t1 = (-b - disc) / (2.0 * a);
+	if (t1 >= 0 && t1 <= 1)
+	{
+		return t1;
+	}
+
+	return -1.0;
+}
+
+/**
+ * Sends wheel targets to the velocity controllers
+ */
+static void pp_SendTargets(purePursuit *pp)
+{
+	if (pp->leftController != NULL)
+	{
+		vel_PID_SetTargetVelocity(pp->leftController, pp->leftVelocity);
+	}
+
+	if (pp->rightController != NULL)
+	{
+		vel_PID_SetTargetVelocity(pp->rightController, pp->rightVelocity);
+	}
+}
+
+/**
+ * Steps the path follower
+ *
+ * @param pp The path follower
+ * @param pose Current robot pose
+ * @return Whether the end of the path was reached
+ */
+bool pp_StepController(purePursuit *pp, const odomPose *pose)
+{
+	if (pp->done)
+	{
+		return true;
+	}
+
+	const ppPathPoint *path = pp->path;
+	const unsigned int last = pp->size - 1;
+
+	//Closest point only moves forward, so walk from the last one while points get closer
+	float dx = path[pp->closestIndex].x - pose->x, dy = path[pp->closestIndex].y - pose->y;
+	float closestDist = dx * dx + dy * dy;
+
+	while (pp->closestIndex < last)
+	{
+		dx = path[pp->closestIndex + 1].x - pose->x;
+		dy = path[pp->closestIndex + 1].y - pose->y;
+
+		if (dx * dx + dy * dy > closestDist)
+		{
+			break;
+		}
+
+		closestDist = dx * dx + dy * dy;
+		pp->closestIndex++;
+	}
+
+	//Lookahead point also only moves forward; stop searching once segments are out of reach
+	const float searchEnd = path[pp->closestIndex].distance + 2.0 * pp->lookahead;
+	unsigned int i = pp->lookaheadIndex > pp->closestIndex ? pp->lookaheadIndex : pp->closestIndex;
+
+	for (; i < last && path[i].distance <= searchEnd; i++)
+	{
+		const float t = pp_Intersect(&(path[i]), &(path[i + 1]), pose->x, pose->y, pp->lookahead);
+
+		if (t >= 0 && (i > pp->lookaheadIndex || t >= pp->lookaheadFrac))
+		{
+			pp->lookaheadIndex = i;
+			pp->lookaheadFrac = t;
+			pp->lookaheadX = path[i].x + t * (path[i + 1].x - path[i].x);
+			pp->lookaheadY = path[i].y + t * (path[i + 1].y - path[i].y);
+			break;
+		}
+	}
+
+	//Near the end the circle no longer crosses the path, so aim at the last point
+	dx = path[last].x - pose->x;
+	dy = path[last].y - pose->y;
+
+	if (dx * dx + dy * dy < pp->lookahead * pp->lookahead)
+	{
+		pp->lookaheadIndex = last;
+		pp->lookaheadFrac = 0.0;
+		pp->lookaheadX = path[last].x;
+		pp->lookaheadY = path[last].y;
+	}
+
+	if (dx * dx + dy * dy < pp->stopDistance * pp->stopDistance && pp->closestIndex + 1 >= last)
+	{
+		pp->done = true;
+		pp->velocity = 0.0;
+		pp->leftVelocity = 0.0;
+		pp->rightVelocity = 0.0;
+		pp_SendTargets(pp);
+		return true;
+	}
+
+	//Rate limit acceleration; slowing down is already shaped by the path velocities
+	const unsigned long now = millis();
+	const float dt = pp->prevTime == 0 ? 0.0 : (now - pp->prevTime) / 1000.0;
+	const float maxStep = pp->velocity + pp->maxAccel * dt;
+	const float pathVelocity = path[pp->closestIndex].velocity;
+
+	pp->prevTime = now;
+	pp->velocity = pathVelocity > maxStep ? maxStep : pathVelocity;
+
+	//Curvature of the arc through the lookahead point, from its sideways offset
+	const float lx = pp->lookaheadX - pose->x, ly = pp->lookaheadY - pose->y;
+	const float lateral = cosf(pose->theta) * ly - sinf(pose->theta) * lx;
+	const float distSq = lx * lx + ly * ly;
+
+	pp->curvature = distSq > 1e-6 ? 2.0 * lateral / distSq : 0.0;
+
+	//Split speed between the sides and convert to wheel RPM
+	const float toRPM = 60.0 / (PI * pp->wheelDiam);
+	const float turn = pp->curvature * pp->trackWidth * 0.5;
+
+	pp->leftVelocity = pp->velocity * (1.0 - turn) * toRPM;
+	pp->rightVelocity = pp->velocity * (1.0 + turn) * toRPM;
+
+	pp_SendTargets(pp);
+
+	return false;
+}
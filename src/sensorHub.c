@@ -0,0 +1,221 @@
+#include <stddef.h>
+#include "API.h"
+#include "doubleBuffer.h"
+#include "sensorHub.h"
+
+//Registered sensors
+static sensorSource sensorSources[SENSOR_HUB_MAX];
+static int sensorCount = 0;
+
+//Snapshot being filled by the hub task
+static sensorSnapshot sensorWorking;
+
+//Published snapshots: the hub task writes the back one and then flips, readers copy the front one
+static sensorSnapshot sensorSnapshots[2];
+static doubleBuffer sensorPublished = DOUBLE_BUFFER(sensorSnapshots);
+
+/**
+ * Registers a sensor of any type
+ */
+static int sensorHubAdd(const sensorType type, const unsigned char port, void *handle, int (*read)(bool *))
+{
+	if (sensorCount >= SENSOR_HUB_MAX)
+	{
+		return -1;
+	}
+
+	sensorSource *s = &(sensorSources[sensorCount]);
+	s->type = type;
+	s->port = port;
+	s->handle = handle;
+	s->read = read;
+
+	sensorWorking.readings[sensorCount].value = 0;
+	sensorWorking.readings[sensorCount].time = 0;
+	sensorWorking.readings[sensorCount].valid = false;
+
+	return sensorCount++;
+}
+
+/**
+ * Registers an encoder
+ *
+ * @param enc The encoder
+ * @return Sensor ID, or -1 if the hub is full
+ */
+int sensorHub_AddEncoder(Encoder enc)
+{
+	return sensorHubAdd(SENSOR_ENCODER, 0, enc, NULL);
+}
+
+/**
+ * Registers an IME count
+ *
+ * @param address IME address
+ * @return Sensor ID, or -1 if the hub is full
+ */
+int sensorHub_AddIME(const unsigned char address)
+{
+	return sensorHubAdd(SENSOR_IME, address, NULL, NULL);
+}
+
+/**
+ * Registers an IME velocity
+ *
+ * @param address IME address
+ * @return Sensor ID, or -1 if the hub is full
+ */
+int sensorHub_AddIMEVelocity(const unsigned char address)
+{
+	return sensorHubAdd(SENSOR_IME_VELOCITY, address, NULL, NULL);
+}
+
+/**
+ * Registers an analog input
+ *
+ * @param channel Analog channel (1 to BOARD_NR_ADC_PINS)
+ * @param highRes Read with analogReadCalibratedHR instead of analogRead
+ * @return Sensor ID, or -1 if the hub is full
+ */
+int sensorHub_AddAnalog(const unsigned char channel, const bool highRes)
+{
+	return sensorHubAdd(highRes ? SENSOR_ANALOG_HR : SENSOR_ANALOG, channel, NULL, NULL);
+}
+
+/**
+ * Registers a digital input
+ *
+ * @param pin Digital pin
+ * @return Sensor ID, or -1 if the hub is full
+ */
+int sensorHub_AddDigital(const unsigned char pin)
+{
+	return sensorHubAdd(SENSOR_DIGITAL, pin, NULL, NULL);
+}
+
+/**
+ * Registers a gyro
+ *
+ * @param gyro The gyro
+ * @return Sensor ID, or -1 if the hub is full
+ */
+int sensorHub_AddGyro(Gyro gyro)
+{
+	return sensorHubAdd(SENSOR_GYRO, 0, gyro, NULL);
+}
+
+/**
+ * Registers a user function, sampled in order with the other sensors
+ *
+ * @param read Returns a reading and sets its argument to whether the read worked
+ * @return Sensor ID, or -1 if the hub is full
+ */
+int sensorHub_AddCustom(int (*read)(bool *ok))
+{
+	return sensorHubAdd(SENSOR_CUSTOM, 0, NULL, read);
+}
+
+/**
+ * Samples every registered sensor once and publishes the snapshot
+ * Called by the hub task; only call directly if the task is not running
+ */
+void sensorHub_Sample()
+{
+	sensorWorking.time = micros();
+	sensorWorking.sequence++;
+
+	for (int i = 0; i < sensorCount; i++)
+	{
+		const sensorSource *s = &(sensorSources[i]);
+		sensorReading *r = &(sensorWorking.readings[i]);
+		int value = r->value;
+		bool ok = true;
+
+		switch (s->type)
+		{
+			case SENSOR_ENCODER:
+				value = encoderGet(s->handle);
+				break;
+
+			case SENSOR_IME:
+				ok = imeGet(s->port, &value);
+				break;
+
+			case SENSOR_IME_VELOCITY:
+				ok = imeGetVelocity(s->port, &value);
+				break;
+
+			case SENSOR_ANALOG:
+				value = analogRead(s->port);
+				break;
+
+			case SENSOR_ANALOG_HR:
+				value = analogReadCalibratedHR(s->port);
+				break;
+
+			case SENSOR_DIGITAL:
+				value = digitalRead(s->port);
+				break;
+
+			case SENSOR_GYRO:
+				value = gyroGet(s->handle);
+				break;
+
+			case SENSOR_CUSTOM:
+				value = s->read(&ok);
+				break;
+		}
+
+		//A failed read keeps the last good value
+		if (ok)
+		{
+			r->value = value;
+			r->time = micros();
+		}
+
+		r->valid = ok;
+	}
+
+	doubleBuffer_Write(&sensorPublished, &sensorWorking);
+}
+
+/**
+ * Copies the latest snapshot (every reading from the same pass)
+ *
+ * @param out Snapshot to fill
+ */
+void sensorHub_GetSnapshot(sensorSnapshot *out)
+{
+	doubleBuffer_Read(&sensorPublished, out, 0, sizeof(sensorSnapshot));
+}
+
+/**
+ * Gets the latest reading of one sensor
+ *
+ * @param id Sensor ID
+ */
+sensorReading sensorHub_GetReading(const int id)
+{
+	sensorReading r;
+	doubleBuffer_Read(&sensorPublished, &r, offsetof(sensorSnapshot, readings) + id * sizeof(sensorReading), sizeof(sensorReading));
+
+	return r;
+}
+
+/**
+ * Gets the latest value of one sensor
+ *
+ * @param id Sensor ID
+ */
+int sensorHub_Get(const int id)
+{
+	return sensorHub_GetReading(id).value;
+}
+
+/*
+ * Starts the sensor hub task
+ */
+void startSensorHubTask()
+{
+	taskRunLoop(sensorHub_Sample, SENSOR_HUB_PERIOD);
+}
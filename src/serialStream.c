@@ -0,0 +1,253 @@
+#include <string.h>
+#include "API.h"
+#include "serialStream.h"
+
+//Latest channel values
+static volatile float streamValues[STREAM_CHANNELS];
+
+//Channels to send
+static volatile unsigned int streamSubscribed = 0;
+
+//Frame counter
+static unsigned char streamSequence = 0;
+
+//Frame buffers, word aligned and contiguous so each frame goes out in one write
+static unsigned char streamRaw[STREAM_MAX_RAW] __attribute__((aligned(4)));
+static unsigned char streamEncoded[STREAM_MAX_ENCODED + 1] __attribute__((aligned(4)));
+
+//Bytes received from the host since the last delimiter
+static unsigned char streamRx[STREAM_MAX_ENCODED];
+static unsigned int streamRxLength = 0;
+static unsigned int streamBadFrames = 0;
+
+//CRC-16/CCITT-FALSE, four bits at a time
+static const unsigned short streamCrcTable[16] = {
+	0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+	0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF
+};
+
+/**
+ * Calculates a CRC-16/CCITT-FALSE checksum
+ *
+ * @param data Bytes to checksum
+ * @param length Number of bytes
+ */
+unsigned short stream_Crc16(const unsigned char *data, const unsigned int length)
+{
+	unsigned short crc = 0xFFFF;
+
+	for (unsigned int i = 0; i < length; i++)
+	{
+		crc = (crc << 4) ^ streamCrcTable[(crc >> 12) ^ (data[i] >> 4)];
+		crc = (crc << 4) ^ streamCrcTable[(crc >> 12) ^ (data[i] & 0x0F)];
+	}
+
+	return crc;
+}
+
+/**
+ * COBS encodes a buffer so it contains no zero bytes
+ *
+ * @param in Bytes to encode
+ * @param length Number of bytes
+ * @param out Output, at least length + length / 254 + 1 bytes
+ * @return Encoded length (without a delimiter)
+ */
+unsigned int stream_CobsEncode(const unsigned char *in, const unsigned int length, unsigned char *out)
+{
+	unsigned int codeIndex = 0, outIndex = 1;
+	unsigned char code = 1;
+
+	for (unsigned int i = 0; i < length; i++)
+	{
+		if (in[i] != 0)
+		{
+			out[outIndex++] = in[i];
+			code++;
+		}
+
+		//Close the block at a zero or once it is full
+		if (in[i] == 0 || code == 0xFF)
+		{
+			out[codeIndex] = code;
+			codeIndex = outIndex++;
+			code = 1;
+		}
+	}
+
+	out[codeIndex] = code;
+
+	return outIndex;
+}
+
+/**
+ * Decodes a COBS encoded buffer
+ *
+ * @param in Encoded bytes (without the zero delimiter)
+ * @param length Number of encoded bytes
+ * @param out Output, at least length bytes
+ * @return Decoded length, or 0 if the input is malformed
+ */
+unsigned int stream_CobsDecode(const unsigned char *in, const unsigned int length, unsigned char *out)
+{
+	unsigned int inIndex = 0, outIndex = 0;
+
+	while (inIndex < length)
+	{
+		const unsigned char code = in[inIndex++];
+
+		if (code == 0 || inIndex + code - 1 > length)
+		{
+			return 0;
+		}
+
+		for (unsigned char i = 1; i < code; i++)
+		{
+			out[outIndex++] = in[inIndex++];
+		}
+
+		//A block shorter than 254 bytes stands for a zero, unless it ends the frame
+		if (code < 0xFF && inIndex < length)
+		{
+			out[outIndex++] = 0;
+		}
+	}
+
+	return outIndex;
+}
+
+/**
+ * Sets the latest value of a channel
+ * Only stores the value, so it is cheap enough to call from any control loop
+ *
+ * @param channel Channel number (less than STREAM_CHANNELS)
+ * @param value New value
+ */
+void stream_Set(const unsigned char channel, const float value)
+{
+	streamValues[channel] = value;
+}
+
+/**
+ * Sets which channels are streamed
+ *
+ * @param mask Subscription mask (bit n streams channel n)
+ */
+void stream_Subscribe(const unsigned int mask)
+{
+	streamSubscribed = mask;
+}
+
+/**
+ * Gets which channels are streamed
+ */
+unsigned int stream_GetSubscribed()
+{
+	return streamSubscribed;
+}
+
+/**
+ * Gets the number of malformed frames received from the host
+ */
+unsigned int stream_GetBadFrames()
+{
+	return streamBadFrames;
+}
+
+/**
+ * Handles one complete frame from the host
+ */
+static void streamHandleFrame()
+{
+	unsigned char frame[STREAM_MAX_ENCODED];
+	const unsigned int length = stream_CobsDecode(streamRx, streamRxLength, frame);
+
+	//Type, mask, CRC
+	if (length != 7 || stream_Crc16(frame, length - 2) != (frame[5] | (frame[6] << 8)) || frame[0] != STREAM_TYPE_SUB)
+	{
+		streamBadFrames++;
+		return;
+	}
+
+	streamSubscribed = frame[1] | (frame[2] << 8) | (frame[3] << 16) | ((unsigned int)frame[4] << 24);
+}
+
+/**
+ * Reads subscription changes from the host and sends one frame of subscribed channels
+ */
+static void streamTask()
+{
+	//Incoming frames
+	while (fcount(uart2) > 0)
+	{
+		const int c = fgetc(uart2);
+
+		if (c == 0)
+		{
+			if (streamRxLength > 0)
+			{
+				streamHandleFrame();
+			}
+
+			streamRxLength = 0;
+		}
+		else if (c > 0 && streamRxLength < sizeof(streamRx))
+		{
+			streamRx[streamRxLength++] = c;
+		}
+	}
+
+	const unsigned int mask = streamSubscribed;
+
+	if (mask == 0)
+	{
+		return;
+	}
+
+	//Header
+	const unsigned int now = millis();
+	unsigned int length = 0;
+
+	streamRaw[length++] = STREAM_TYPE_DATA;
+	streamRaw[length++] = streamSequence++;
+	memcpy(&(streamRaw[length]), &now, 4);
+	length += 4;
+	memcpy(&(streamRaw[length]), &mask, 4);
+	length += 4;
+
+	//Values in channel order
+	for (unsigned char ch = 0; ch < STREAM_CHANNELS; ch++)
+	{
+		if (mask & (1U << ch))
+		{
+			const float value = streamValues[ch];
+			memcpy(&(streamRaw[length]), &value, 4);
+			length += 4;
+		}
+	}
+
+	const unsigned short crc = stream_Crc16(streamRaw, length);
+	streamRaw[length++] = crc & 0xFF;
+	streamRaw[length++] = crc >> 8;
+
+	//Encode, delimit, and send in a single write
+	length = stream_CobsEncode(streamRaw, length, streamEncoded);
+	streamEncoded[length++] = 0;
+
+	fwrite(streamEncoded, 1, length, uart2);
+}
+
+/**
+ * Opens uart2 and starts streaming subscribed channels
+ *
+ * @param baud Baud rate (e.g. STREAM_DEFAULT_BAUD)
+ * @param subscribed Initial subscription mask (bit n streams channel n)
+ */
+void stream_Start(const unsigned int baud, const unsigned int subscribed)
+{
+	streamSubscribed = subscribed;
+	streamRxLength = 0;
+
+	usartInit(uart2, baud, SERIAL_8N1);
+	taskRunLoop(streamTask, STREAM_PERIOD);
+}
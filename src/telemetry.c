@@ -0,0 +1,236 @@
+#include "API.h"
+#include "telemetry.h"
+
+//Record storage
+static telemetryRecord telemetryRecords[TELEMETRY_BUFFER_SIZE];
+
+//Sequence stamp of each slot, written last so the drain only reads complete records
+static volatile unsigned int telemetryReady[TELEMETRY_BUFFER_SIZE];
+
+//Next record to reserve (producers) and to drain (consumer)
+static volatile unsigned int telemetryHead = 0;
+static volatile unsigned int telemetryTail = 0;
+
+//Counters
+static volatile unsigned int telemetryDropped = 0;
+static unsigned int telemetryWriteErrors = 0;
+static unsigned int telemetryDroppedLogged = 0;
+
+//Log file and the mutex guarding it between the drain task and telemetry_Stop
+static FILE *telemetryFile = NULL;
+static Mutex telemetryFileMutex = NULL;
+static TaskHandle telemetryTask = NULL;
+
+/**
+ * Initializes (or clears) the telemetry buffer
+ * Call once before pushing records from any task
+ */
+void telemetry_Init()
+{
+	telemetryHead = 0;
+	telemetryTail = 0;
+	telemetryDropped = 0;
+	telemetryWriteErrors = 0;
+	telemetryDroppedLogged = 0;
+
+	for (int i = 0; i < TELEMETRY_BUFFER_SIZE; i++)
+	{
+		telemetryReady[i] = 0;
+	}
+
+	if (telemetryFileMutex == NULL)
+	{
+		telemetryFileMutex = mutexCreate();
+	}
+}
+
+/**
+ * Drains the buffer to the log file periodically
+ */
+static void telemetryDrainTask(void *ignored)
+{
+	while (true)
+	{
+		telemetry_Flush();
+		delay(TELEMETRY_DRAIN_DELAY);
+	}
+}
+
+/**
+ * Opens a log file and starts a low priority task which drains the buffer into it
+ *
+ * @param file File name on the PROS file system
+ * @return Whether the file was opened
+ */
+bool telemetry_Start(const char *file)
+{
+	if (telemetryFileMutex == NULL)
+	{
+		telemetry_Init();
+	}
+
+	FILE *f = fopen(file, "w");
+
+	if (f == NULL)
+	{
+		return false;
+	}
+
+	const telemetryHeader header = {TELEMETRY_MAGIC, TELEMETRY_VERSION, sizeof(telemetryRecord)};
+	fwrite(&header, sizeof(header), 1, f);
+
+	mutexTake(telemetryFileMutex, -1);
+	telemetryFile = f;
+	mutexGive(telemetryFileMutex);
+
+	if (telemetryTask == NULL)
+	{
+		telemetryTask = taskCreate(telemetryDrainTask, TASK_DEFAULT_STACK_SIZE, NULL, TASK_PRIORITY_LOWEST + 1);
+	}
+
+	return true;
+}
+
+/**
+ * Drains the buffer and closes the log file (the file is only kept once closed)
+ */
+void telemetry_Stop()
+{
+	telemetry_Flush();
+
+	mutexTake(telemetryFileMutex, -1);
+
+	if (telemetryFile != NULL)
+	{
+		fclose(telemetryFile);
+		telemetryFile = NULL;
+	}
+
+	mutexGive(telemetryFileMutex);
+}
+
+/**
+ * Pushes a record into the buffer
+ * Lock-free and safe to call from any task; never blocks
+ *
+ * @param channel User-defined channel ID
+ * @param value Value to record
+ * @return Whether there was room for the record
+ */
+bool telemetry_Push(const unsigned short channel, const float value)
+{
+	return telemetry_PushAt(millis(), channel, value);
+}
+
+/**
+ * Pushes a record with its own timestamp into the buffer
+ * For controller steps, pass the controller's prevTime so a replay steps at exactly the same time
+ *
+ * @param time Timestamp in ms
+ * @param channel User-defined channel ID
+ * @param value Value to record
+ * @return Whether there was room for the record
+ */
+bool telemetry_PushAt(const unsigned int time, const unsigned short channel, const float value)
+{
+	unsigned int head;
+
+	//Reserve a slot
+	do
+	{
+		head = telemetryHead;
+
+		if (head - telemetryTail >= TELEMETRY_BUFFER_SIZE)
+		{
+			__sync_fetch_and_add(&telemetryDropped, 1);
+			return false;
+		}
+	} while (!__sync_bool_compare_and_swap(&telemetryHead, head, head + 1));
+
+	telemetryRecord *r = &(telemetryRecords[head & (TELEMETRY_BUFFER_SIZE - 1)]);
+	r->time = time;
+	r->channel = channel;
+	r->sequence = head;
+	r->value = value;
+
+	//Publish the slot
+	__sync_synchronize();
+	telemetryReady[head & (TELEMETRY_BUFFER_SIZE - 1)] = head + 1;
+
+	return true;
+}
+
+/**
+ * Writes buffered records to the log file (or discards them if no file is open)
+ *
+ * @return Number of records drained
+ */
+unsigned int telemetry_Flush()
+{
+	telemetryRecord batch[TELEMETRY_DRAIN_BATCH];
+	unsigned int drained = 0;
+
+	mutexTake(telemetryFileMutex, -1);
+
+	while (true)
+	{
+		unsigned int count = 0;
+
+		//Copy out complete records, stopping at one still being written
+		while (count < TELEMETRY_DRAIN_BATCH && telemetryTail != telemetryHead)
+		{
+			const unsigned int slot = telemetryTail & (TELEMETRY_BUFFER_SIZE - 1);
+
+			if (telemetryReady[slot] != telemetryTail + 1)
+			{
+				break;
+			}
+
+			batch[count++] = telemetryRecords[slot];
+			__sync_synchronize();
+			telemetryTail++;
+		}
+
+		if (count == 0)
+		{
+			break;
+		}
+
+		if (telemetryFile != NULL && fwrite(batch, sizeof(telemetryRecord), count, telemetryFile) != count)
+		{
+			telemetryWriteErrors += count;
+		}
+
+		drained += count;
+	}
+
+	//Log overflow so it shows up in the file
+	const unsigned int dropped = telemetryDropped;
+
+	if (telemetryFile != NULL && dropped != telemetryDroppedLogged)
+	{
+		const telemetryRecord r = {millis(), TELEMETRY_CH_DROPPED, 0, dropped};
+		fwrite(&r, sizeof(r), 1, telemetryFile);
+		telemetryDroppedLogged = dropped;
+	}
+
+	mutexGive(telemetryFileMutex);
+
+	return drained;
+}
+
+/**
+ * Gets the number of records dropped because the buffer was full
+ */
+unsigned int telemetry_GetDropped()
+{
+	return telemetryDropped;
+}
+
+/**
+ * Gets the number of records lost to failed file writes
+ */
+unsigned int telemetry_GetWriteErrors()
+{
+	return telemetryWriteErrors;
+}
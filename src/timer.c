@@ -20,8 +20,10 @@ timer* timer_Initialize(timer *timer)
  */
 long timer_GetDT(timer *timer)
 {
-	long dt = millis() - timer->lastCalled;
-	timer->lastCalled = millis();
+	//Read the clock once so the stored time is the one subtracted
+	const long now = millis();
+	const long dt = now - timer->lastCalled;
+	timer->lastCalled = now;
 	return dt;
 }
 
@@ -86,17 +88,34 @@ long timer_GetDTFromHardMarker(timer *timer)
 
 /**
  * Returns true when a time period has passed, then resets
+ * Periods are counted from the first call, not from when the caller noticed, so they never drift
  */
 bool timer_Repeat(timer *timer, long timeMs)
 {
+	const long now = millis();
+
+	//A zero period (e.g. a rate rounded down to 0ms) fires every call rather than dividing by zero
+	if (timeMs <= 0)
+	{
+		timer->repeatMark = now;
+		return true;
+	}
+
 	if (timer->repeatMark == -1)
 	{
-		timer->repeatMark = millis();
+		timer->repeatMark = now;
 	}
 
-	if (millis() - timer->repeatMark > timeMs)
+	if (now - timer->repeatMark >= timeMs)
 	{
-		timer->repeatMark = -1;
+		//Advance by whole periods, skipping any the caller missed entirely
+		timer->repeatMark += timeMs;
+
+		if (now - timer->repeatMark >= timeMs)
+		{
+			timer->repeatMark = now - (now - timer->repeatMark) % timeMs;
+		}
+
 		return true;
 	}
 
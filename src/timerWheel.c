@@ -0,0 +1,260 @@
+#include "API.h"
+#include "timerWheel.h"
+
+//Slot lists are circular with a sentinel head, so linking and unlinking never branch on empty lists
+static wheelTimer wheelRoot[TIMER_WHEEL_ROOT_SIZE];
+static wheelTimer wheelLevels[TIMER_WHEEL_LEVELS - 1][TIMER_WHEEL_LEVEL_SIZE];
+
+//Timers taken off a slot and waiting for their callback
+static wheelTimer wheelDue;
+
+//Next tick (ms) the wheel will process
+static unsigned long wheelTime = 0;
+
+//Guards the lists between the wheel task and tasks adding or cancelling timers
+static Mutex wheelMutex = NULL;
+
+static void wheelListInit(wheelTimer *head)
+{
+	head->next = head;
+	head->prev = head;
+}
+
+static void wheelUnlink(wheelTimer *t)
+{
+	t->prev->next = t->next;
+	t->next->prev = t->prev;
+	t->next = NULL;
+	t->prev = NULL;
+}
+
+static void wheelLink(wheelTimer *head, wheelTimer *t)
+{
+	t->next = head;
+	t->prev = head->prev;
+	head->prev->next = t;
+	head->prev = t;
+}
+
+/**
+ * Links a timer into the slot covering its expiry
+ */
+static void wheelInsert(wheelTimer *t)
+{
+	long delta = t->expires - wheelTime;
+
+	//Late timers fire on the next tick
+	if (delta < 0)
+	{
+		delta = 0;
+	}
+
+	//Beyond the outer level, park in its last slot and re-cascade from there
+	const unsigned long max = (1UL << (TIMER_WHEEL_ROOT_BITS + (TIMER_WHEEL_LEVELS - 1) * TIMER_WHEEL_LEVEL_BITS)) - 1;
+	const unsigned long slotTime = wheelTime + ((unsigned long)delta > max ? max : (unsigned long)delta);
+
+	if ((unsigned long)delta < TIMER_WHEEL_ROOT_SIZE)
+	{
+		wheelLink(&(wheelRoot[slotTime & (TIMER_WHEEL_ROOT_SIZE - 1)]), t);
+		return;
+	}
+
+	int level = 0;
+	unsigned int shift = TIMER_WHEEL_ROOT_BITS;
+
+	while (level < TIMER_WHEEL_LEVELS - 2 && (unsigned long)delta >= 1UL << (shift + TIMER_WHEEL_LEVEL_BITS))
+	{
+		level++;
+		shift += TIMER_WHEEL_LEVEL_BITS;
+	}
+
+	wheelLink(&(wheelLevels[level][(slotTime >> shift) & (TIMER_WHEEL_LEVEL_SIZE - 1)]), t);
+}
+
+/**
+ * Moves one outer slot's timers down to finer slots
+ *
+ * @return The slot index, which is 0 when the next level up must cascade too
+ */
+static unsigned int wheelCascade(const int level)
+{
+	const unsigned int index = (wheelTime >> (TIMER_WHEEL_ROOT_BITS + level * TIMER_WHEEL_LEVEL_BITS)) & (TIMER_WHEEL_LEVEL_SIZE - 1);
+	wheelTimer *head = &(wheelLevels[level][index]);
+
+	while (head->next != head)
+	{
+		wheelTimer *t = head->next;
+		wheelUnlink(t);
+		wheelInsert(t);
+	}
+
+	return index;
+}
+
+/**
+ * Initializes the timer wheel (call once before adding timers)
+ */
+void timerWheel_Init()
+{
+	for (int i = 0; i < TIMER_WHEEL_ROOT_SIZE; i++)
+	{
+		wheelListInit(&(wheelRoot[i]));
+	}
+
+	for (int level = 0; level < TIMER_WHEEL_LEVELS - 1; level++)
+	{
+		for (int i = 0; i < TIMER_WHEEL_LEVEL_SIZE; i++)
+		{
+			wheelListInit(&(wheelLevels[level][i]));
+		}
+	}
+
+	wheelListInit(&wheelDue);
+	wheelTime = millis();
+
+	if (wheelMutex == NULL)
+	{
+		wheelMutex = mutexCreate();
+	}
+}
+
+/**
+ * Initializes a timer (call once before its first timerWheel_Add)
+ *
+ * @param t The timer
+ */
+void timerWheel_InitTimer(wheelTimer *t)
+{
+	t->next = NULL;
+	t->prev = NULL;
+	t->expires = 0;
+	t->period = 0;
+	t->callback = NULL;
+	t->arg = NULL;
+}
+
+/**
+ * Starts a timer, restarting it if it is already active
+ * O(1); callbacks run in the timer wheel task and must not block
+ *
+ * @param t The timer
+ * @param delayMs Time until the first callback in ms
+ * @param periodMs Interval between later callbacks in ms, or 0 for one-shot
+ * @param callback Function to call
+ * @param arg Argument passed to callback
+ */
+void timerWheel_Add(wheelTimer *t, const unsigned long delayMs, const unsigned long periodMs, void (*callback)(void *arg), void *arg)
+{
+	mutexTake(wheelMutex, -1);
+
+	if (t->next != NULL)
+	{
+		wheelUnlink(t);
+	}
+
+	t->expires = millis() + delayMs;
+	t->period = periodMs;
+	t->callback = callback;
+	t->arg = arg;
+	wheelInsert(t);
+
+	mutexGive(wheelMutex);
+}
+
+/**
+ * Stops a timer (does nothing if it is not active)
+ * O(1)
+ *
+ * @param t The timer
+ */
+void timerWheel_Cancel(wheelTimer *t)
+{
+	mutexTake(wheelMutex, -1);
+
+	if (t->next != NULL)
+	{
+		wheelUnlink(t);
+	}
+
+	mutexGive(wheelMutex);
+}
+
+/**
+ * Gets whether a timer is waiting to fire
+ *
+ * @param t The timer
+ */
+bool timerWheel_IsActive(wheelTimer *t)
+{
+	return t->next != NULL;
+}
+
+/**
+ * Fires every timer due up to now
+ * Called by the timer wheel task; only call directly if the task is not running
+ */
+void timerWheel_Advance()
+{
+	const unsigned long now = millis();
+
+	mutexTake(wheelMutex, -1);
+
+	while ((long)(now - wheelTime) >= 0)
+	{
+		const unsigned int index = wheelTime & (TIMER_WHEEL_ROOT_SIZE - 1);
+
+		//At the start of each lap, pull the next outer slot down (and its outer slot, at the start of its lap)
+		for (int level = 0; index == 0 && level < TIMER_WHEEL_LEVELS - 1; level++)
+		{
+			if (wheelCascade(level) != 0)
+			{
+				break;
+			}
+		}
+
+		//Take the whole slot at once, so callbacks may add timers to it for a later lap
+		wheelTimer *slot = &(wheelRoot[index]);
+
+		if (slot->next != slot)
+		{
+			wheelDue.next = slot->next;
+			wheelDue.prev = slot->prev;
+			wheelDue.next->prev = &wheelDue;
+			wheelDue.prev->next = &wheelDue;
+			wheelListInit(slot);
+		}
+
+		wheelTime++;
+
+		while (wheelDue.next != &wheelDue)
+		{
+			wheelTimer *t = wheelDue.next;
+			wheelUnlink(t);
+
+			//Periodic timers advance by whole periods from when they were due, so they never drift
+			if (t->period > 0)
+			{
+				t->expires += t->period;
+				wheelInsert(t);
+			}
+
+			//Callbacks may add or cancel timers (including this one), so run them unlocked
+			void (*callback)(void *) = t->callback;
+			void *arg = t->arg;
+
+			mutexGive(wheelMutex);
+			callback(arg);
+			mutexTake(wheelMutex, -1);
+		}
+	}
+
+	mutexGive(wheelMutex);
+}
+
+/*
+ * Starts the timer wheel task
+ */
+void startTimerWheelTask()
+{
+	taskRunLoop(timerWheel_Advance, TIMER_WHEEL_PERIOD);
+}
@@ -30,6 +30,8 @@ void vel_PID_InitController(vel_PID *pid, const float kP, const float kD, const
 	pid->alpha = 0.19;
 	pid->beta = 0.0526;
 
+	pid->schedule = NULL;
+
 	pid->outVal = 0.0;
 }
 
@@ -57,6 +59,17 @@ void vel_PID_SetTargetVelocity(vel_PID *pid, const int targetVelocity)
 	pid->targetVelocity = targetVelocity;
 }
 
+/**
+ * Sets a gain schedule which overrides kP and kD each step
+ *
+ * @param pid The PID controller
+ * @param schedule The gain schedule, or NULL to keep the current gains fixed
+ */
+void vel_PID_SetGainSchedule(vel_PID *pid, gainSchedule *schedule)
+{
+	pid->schedule = schedule;
+}
+
 /**
  * Gets the current error
  *
@@ -129,21 +142,35 @@ int vel_PID_StepVelocity(vel_PID *pid, const float sens)
  */
 int vel_PID_StepController(vel_PID *pid, const float sens)
 {
-	//Calculate current velocity and scrap dt if zero
-	if (vel_PID_StepVelocity(pid, sens) == 0)
+	//Calculate current velocity and keep the last output if dt is zero
+	vel_PID_StepVelocity(pid, sens);
+
+	if (pid->dt == 0)
 	{
-		return 0;
+		return pid->outVal;
 	}
 
 	//Calculate error
 	pid->error = pid->targetVelocity - pid->currentVelocity;
 
+	//Pull gains from the schedule
+	if (pid->schedule != NULL)
+	{
+		gainSchedule_Update(pid->schedule, pid->targetVelocity, pid->currentVelocity);
+		pid->kP = pid->schedule->kP;
+		pid->kD = pid->schedule->kD;
+	}
+
 	//Calculate derivative
-	pid->derivative = (pid->error - pid->prevError) / pid->dt;
+	pid->derivative = (pid->error - pid->prevError) / (int)pid->dt;
 	pid->prevError = pid->error;
 
 	//Sum outVal to compute change in output instead out output itself
 	pid->outVal += (pid->error * pid->kP) + (pid->derivative * pid->kD);
 
+	//Bound outVal so it cannot wind up past what a motor accepts
+	pid->outVal = pid->outVal > 127 ? 127 : pid->outVal;
+	pid->outVal = pid->outVal < -127 ? -127 : pid->outVal;
+
 	return pid->outVal;
 }
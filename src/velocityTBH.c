@@ -185,9 +185,14 @@ int vel_TBH_StepVelocity(vel_TBH *tbh, const float sens)
  */
 int vel_TBH_StepController(vel_TBH *tbh, const float sens)
 {
-	//Calculate current velocity
+	//Calculate current velocity and keep the last output if dt is zero
 	vel_TBH_StepVelocity(tbh, sens);
 
+	if (tbh->dt == 0)
+	{
+		return tbh->outVal;
+	}
+
 	//Calculate error
 	tbh->error = tbh->targetVelocity - tbh->currentVelocity;
 